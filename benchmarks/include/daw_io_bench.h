@@ -0,0 +1,67 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+
+namespace daw::io::bench {
+	/// @brief Prevent the optimizer from discarding value or the work that
+	/// produced it
+	template<typename T>
+	inline void do_not_optimize( T const &value ) {
+#if defined( _MSC_VER )
+		auto const volatile *p = &value;
+		(void)p;
+#else
+		asm volatile( "" : : "r,m"( value ) : "memory" );
+#endif
+	}
+
+	/// @brief Run func iterations times and print the average time per call
+	/// @return The average nanoseconds per call
+	template<typename Func>
+	double run( std::string_view title, std::size_t iterations, Func &&func ) {
+		func( );
+		auto const start = std::chrono::steady_clock::now( );
+		for( std::size_t n = 0; n < iterations; ++n ) {
+			func( );
+		}
+		auto const finish = std::chrono::steady_clock::now( );
+		auto const ns =
+		  std::chrono::duration<double, std::nano>( finish - start ).count( ) /
+		  static_cast<double>( iterations );
+		std::printf( "%-48.*s %10.2f ns/op\n", static_cast<int>( title.size( ) ),
+		             title.data( ), ns );
+		return ns;
+	}
+
+	/// @brief Run func iterations times where each call processes bytes bytes
+	/// and print the throughput
+	/// @return The throughput in MB/s
+	template<typename Func>
+	double run_mbs( std::string_view title, std::size_t bytes,
+	                std::size_t iterations, Func &&func ) {
+		func( );
+		auto const start = std::chrono::steady_clock::now( );
+		for( std::size_t n = 0; n < iterations; ++n ) {
+			func( );
+		}
+		auto const finish = std::chrono::steady_clock::now( );
+		auto const secs =
+		  std::chrono::duration<double>( finish - start ).count( );
+		auto const mbs = static_cast<double>( bytes ) *
+		                 static_cast<double>( iterations ) / secs / 1'000'000.0;
+		std::printf( "%-48.*s %10.2f MB/s\n", static_cast<int>( title.size( ) ),
+		             title.data( ), mbs );
+		return mbs;
+	}
+} // namespace daw::io::bench
@@ -0,0 +1,57 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_read_write.h>
+#include <daw/io/util/daw_io_algorithms.h>
+#include <daw/io/util/daw_io_byte_kernels.h>
+
+#include <cctype>
+#include <cstddef>
+#include <exception>
+#include <string>
+
+namespace {
+	constexpr std::size_t data_size = 16U * 1024U * 1024U;
+	constexpr std::size_t iterations = 4;
+
+	void check( daw::io::util::CopyResult const &r ) {
+		if( r.write_result.count != data_size ) {
+			std::terminate( );
+		}
+	}
+} // namespace
+
+// The byte kernels against transform with a per byte function
+int main( ) {
+	auto const data = std::string( data_size, 'x' );
+	auto out = std::string( );
+	out.reserve( data_size );
+	auto w = daw::io::Writer( out );
+	auto const upper = []( std::byte b ) {
+		return static_cast<std::byte>( std::toupper( static_cast<char>( b ) ) );
+	};
+	auto const run_kernel = [&]( char const *title, auto const &kernel ) {
+		(void)daw::io::bench::run_mbs( title, data_size, iterations, [&] {
+			out.clear( );
+			auto sv = daw::string_view( data );
+			auto r = daw::io::Reader( sv );
+			check( daw::io::util::transform( w, r, kernel ) );
+		} );
+	};
+	run_kernel( "std::string transform", upper );
+	run_kernel( "std::string ascii_to_upper", daw::io::util::ascii_to_upper{ } );
+	run_kernel( "std::string translate_table",
+	            daw::io::util::translate_table::from( upper ) );
+	run_kernel( "std::string replace_byte",
+	            daw::io::util::replace_byte( 'x', 'y' ) );
+	run_kernel( "std::string xor_mask",
+	            daw::io::util::xor_mask( { std::byte{ 1 }, std::byte{ 2 },
+	                                       std::byte{ 3 }, std::byte{ 4 } } ) );
+}
@@ -0,0 +1,130 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_read_write.h>
+#include <daw/io/daw_read_write_fd.h>
+#include <daw/io/util/daw_io_algorithms.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+	constexpr std::size_t data_size = 16U * 1024U * 1024U;
+	constexpr std::size_t iterations = 4;
+	constexpr std::size_t chunk_sizes[] = { 512U, 4096U, 65536U,
+	                                        1024U * 1024U };
+
+	void check( daw::io::util::CopyResult const &r ) {
+		if( r.write_result.count != data_size ) {
+			std::terminate( );
+		}
+	}
+
+	std::string chunk_title( char const *endpoint, std::size_t chunk_size ) {
+		return std::string( endpoint ) + " chunk " + std::to_string( chunk_size );
+	}
+} // namespace
+
+int main( ) {
+	auto const data = std::string( data_size, 'x' );
+	auto buffer = std::vector<std::byte>( chunk_sizes[std::size( chunk_sizes ) - 1] );
+	auto const adaptive = daw::io::util::adaptive_buffer{ };
+
+	char tmp_name[] = "/tmp/daw_copy_chunk_size_bench_XXXXXX";
+	int const src_fd = ::mkstemp( tmp_name );
+	int const null_fd = ::open( "/dev/null", O_WRONLY | O_CLOEXEC );
+	if( src_fd < 0 or null_fd < 0 or
+	    ::write( src_fd, data.data( ), data.size( ) ) !=
+	      static_cast<::ssize_t>( data.size( ) ) ) {
+		std::terminate( );
+	}
+
+	{
+		// The proxy keeps copy from taking the in kernel path
+		auto src = daw::io::fd_wrap_t( src_fd );
+		auto dst = daw::io::fd_wrap_t( null_fd );
+		auto r = daw::io::Reader( src );
+		auto w = daw::io::Writer( daw::io::WriteProxy( dst ) );
+		for( std::size_t chunk_size : chunk_sizes ) {
+			(void)daw::io::bench::run_mbs(
+			  chunk_title( "fd", chunk_size ), data_size, iterations, [&] {
+				  ::lseek( src_fd, 0, SEEK_SET );
+				  check( daw::io::util::copy(
+				    w, r, std::span( buffer ).first( chunk_size ) ) );
+			  } );
+		}
+		(void)daw::io::bench::run_mbs( "fd adaptive", data_size, iterations, [&] {
+			::lseek( src_fd, 0, SEEK_SET );
+			check( daw::io::util::copy( w, r, adaptive ) );
+		} );
+		auto kw = daw::io::Writer( dst );
+		(void)daw::io::bench::run_mbs( "fd kernel copy", data_size, iterations,
+		                               [&] {
+			                               ::lseek( src_fd, 0, SEEK_SET );
+			                               check( daw::io::util::copy( kw, r ) );
+		                               } );
+	}
+	{
+		FILE *src = std::fopen( tmp_name, "rb" );
+		FILE *dst = std::fopen( "/dev/null", "wb" );
+		if( src == nullptr or dst == nullptr ) {
+			std::terminate( );
+		}
+		auto r = daw::io::Reader( src );
+		auto w = daw::io::Writer( dst );
+		for( std::size_t chunk_size : chunk_sizes ) {
+			(void)daw::io::bench::run_mbs(
+			  chunk_title( "FILE*", chunk_size ), data_size, iterations, [&] {
+				  std::rewind( src );
+				  check( daw::io::util::copy(
+				    w, r, std::span( buffer ).first( chunk_size ) ) );
+			  } );
+		}
+		(void)daw::io::bench::run_mbs( "FILE* adaptive", data_size, iterations,
+		                               [&] {
+			                               std::rewind( src );
+			                               check( daw::io::util::copy( w, r, adaptive ) );
+		                               } );
+		std::fclose( src );
+		std::fclose( dst );
+	}
+	{
+		auto out = std::string( );
+		out.reserve( data_size );
+		auto w = daw::io::Writer( out );
+		for( std::size_t chunk_size : chunk_sizes ) {
+			(void)daw::io::bench::run_mbs(
+			  chunk_title( "std::string", chunk_size ), data_size, iterations, [&] {
+				  out.clear( );
+				  auto sv = daw::string_view( data );
+				  auto r = daw::io::Reader( sv );
+				  check( daw::io::util::copy(
+				    w, r, std::span( buffer ).first( chunk_size ) ) );
+			  } );
+		}
+		(void)daw::io::bench::run_mbs(
+		  "std::string adaptive", data_size, iterations, [&] {
+			  out.clear( );
+			  auto sv = daw::string_view( data );
+			  auto r = daw::io::Reader( sv );
+			  check( daw::io::util::copy( w, r, adaptive ) );
+		  } );
+	}
+	::close( src_fd );
+	::close( null_fd );
+	::unlink( tmp_name );
+}
@@ -0,0 +1,68 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_read_write.h>
+
+#include <memory>
+#include <span>
+#include <string>
+
+namespace {
+	// The previous Writer layout, a heap allocated reference
+	template<typename Writable>
+	class heap_writer {
+		struct data_t {
+			Writable &writable_value;
+		};
+		std::unique_ptr<data_t> data;
+
+	public:
+		explicit heap_writer( Writable &w )
+		  : data( new data_t{ w } ) {}
+
+		daw::io::IOOpResult put( char c ) {
+			return daw::io::WritableOutput<Writable>::put( data->writable_value, c );
+		}
+	};
+} // namespace
+
+int main( ) {
+	constexpr std::size_t iterations = 1'000'000;
+	char buff[64];
+	(void)daw::io::bench::run(
+	  "heap handle construct + put", iterations, [&] {
+		  auto sp = std::span<char>( buff );
+		  auto w = heap_writer<std::span<char>>( sp );
+		  daw::io::bench::do_not_optimize( w.put( 'a' ) );
+		  daw::io::bench::do_not_optimize( sp );
+	  } );
+	(void)daw::io::bench::run( "Writer construct + put", iterations, [&] {
+		auto sp = std::span<char>( buff );
+		auto w = daw::io::Writer( sp );
+		daw::io::bench::do_not_optimize( w.put( 'a' ) );
+		daw::io::bench::do_not_optimize( sp );
+	} );
+	(void)daw::io::bench::run( "WriteProxy construct + copy + put", iterations,
+	                           [&] {
+		                           auto sp = std::span<char>( buff );
+		                           auto wp = daw::io::WriteProxy( sp );
+		                           auto wp2 = wp;
+		                           daw::io::bench::do_not_optimize( wp2.put( 'a' ) );
+		                           daw::io::bench::do_not_optimize( sp );
+	                           } );
+	auto sv = daw::string_view( "a" );
+	(void)daw::io::bench::run( "Reader construct + get", iterations, [&] {
+		auto s = sv;
+		auto r = daw::io::Reader( s );
+		char c = 0;
+		daw::io::bench::do_not_optimize( r.get( c ) );
+		daw::io::bench::do_not_optimize( c );
+	} );
+}
@@ -0,0 +1,53 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_read_write.h>
+#include <daw/io/util/daw_io_algorithms.h>
+#include <daw/io/util/daw_io_parallel_transform.h>
+
+#include <cctype>
+#include <cstddef>
+#include <exception>
+#include <string>
+
+namespace {
+	constexpr std::size_t data_size = 16U * 1024U * 1024U;
+	constexpr std::size_t iterations = 4;
+
+	void check( daw::io::util::CopyResult const &r ) {
+		if( r.write_result.count != data_size ) {
+			std::terminate( );
+		}
+	}
+} // namespace
+
+// parallel_transform against transform on the calling thread
+int main( ) {
+	auto const data = std::string( data_size, 'x' );
+	auto out = std::string( );
+	out.reserve( data_size );
+	auto w = daw::io::Writer( out );
+	auto const upper = []( std::byte b ) {
+		return static_cast<std::byte>( std::toupper( static_cast<char>( b ) ) );
+	};
+	(void)daw::io::bench::run_mbs(
+	  "std::string transform", data_size, iterations, [&] {
+		  out.clear( );
+		  auto sv = daw::string_view( data );
+		  auto r = daw::io::Reader( sv );
+		  check( daw::io::util::transform( w, r, upper ) );
+	  } );
+	(void)daw::io::bench::run_mbs(
+	  "std::string parallel_transform", data_size, iterations, [&] {
+		  out.clear( );
+		  check( daw::io::util::parallel_transform(
+		    w, daw::string_view( data ), upper ) );
+	  } );
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_read_write.h>
+#include <daw/io/daw_read_write_fd.h>
+#include <daw/io/util/daw_io_algorithms.h>
+#include <daw/io/util/daw_io_pipelined_copy.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+	constexpr std::size_t data_size = 16U * 1024U * 1024U;
+	constexpr std::size_t iterations = 4;
+
+	void check( daw::io::util::CopyResult const &r ) {
+		if( r.write_result.count != data_size ) {
+			std::terminate( );
+		}
+	}
+} // namespace
+
+// pipelined_copy against copy with an adaptive buffer, where reading and
+// writing take turns on one thread
+int main( ) {
+	auto const data = std::string( data_size, 'x' );
+	auto const adaptive = daw::io::util::adaptive_buffer{ };
+
+	char tmp_name[] = "/tmp/daw_pipelined_copy_bench_XXXXXX";
+	int const src_fd = ::mkstemp( tmp_name );
+	int const null_fd = ::open( "/dev/null", O_WRONLY | O_CLOEXEC );
+	if( src_fd < 0 or null_fd < 0 or
+	    ::write( src_fd, data.data( ), data.size( ) ) !=
+	      static_cast<::ssize_t>( data.size( ) ) ) {
+		std::terminate( );
+	}
+
+	{
+		// The proxy keeps copy from taking the in kernel path
+		auto src = daw::io::fd_wrap_t( src_fd );
+		auto dst = daw::io::fd_wrap_t( null_fd );
+		auto r = daw::io::Reader( src );
+		auto w = daw::io::Writer( daw::io::WriteProxy( dst ) );
+		(void)daw::io::bench::run_mbs( "fd adaptive", data_size, iterations, [&] {
+			::lseek( src_fd, 0, SEEK_SET );
+			check( daw::io::util::copy( w, r, adaptive ) );
+		} );
+		(void)daw::io::bench::run_mbs( "fd pipelined", data_size, iterations, [&] {
+			::lseek( src_fd, 0, SEEK_SET );
+			check( daw::io::util::pipelined_copy( w, r ) );
+		} );
+	}
+	{
+		FILE *src = std::fopen( tmp_name, "rb" );
+		FILE *dst = std::fopen( "/dev/null", "wb" );
+		if( src == nullptr or dst == nullptr ) {
+			std::terminate( );
+		}
+		auto r = daw::io::Reader( src );
+		auto w = daw::io::Writer( dst );
+		(void)daw::io::bench::run_mbs( "FILE* adaptive", data_size, iterations,
+		                               [&] {
+			                               std::rewind( src );
+			                               check( daw::io::util::copy( w, r, adaptive ) );
+		                               } );
+		(void)daw::io::bench::run_mbs( "FILE* pipelined", data_size, iterations,
+		                               [&] {
+			                               std::rewind( src );
+			                               check( daw::io::util::pipelined_copy( w, r ) );
+		                               } );
+		std::fclose( src );
+		std::fclose( dst );
+	}
+	::close( src_fd );
+	::close( null_fd );
+	::unlink( tmp_name );
+}
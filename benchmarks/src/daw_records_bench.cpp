@@ -0,0 +1,60 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_delimited_reader.h>
+#include <daw/io/daw_read_write.h>
+#include <daw/io/util/daw_io_parallel_records.h>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <string>
+
+namespace {
+	constexpr std::size_t data_size = 16U * 1024U * 1024U;
+	constexpr std::size_t iterations = 4;
+} // namespace
+
+// Splitting into records with LineReader on one thread, and with
+// for_each_record_parallel on several
+int main( ) {
+	// Records of 100 bytes, the per record cost dominates
+	auto lines = std::string( );
+	lines.reserve( data_size );
+	while( lines.size( ) + 100U <= data_size ) {
+		lines.append( 99U, 'l' );
+		lines += '\n';
+	}
+	lines.resize( data_size, 'l' );
+	(void)daw::io::bench::run_mbs( "LineReader", data_size, iterations, [&] {
+		auto sv = daw::string_view( lines );
+		auto lr = daw::io::LineReader( daw::io::Reader( sv ) );
+		std::size_t total = 0;
+		while( auto const line = lr.next( ) ) {
+			total += line->size( ) + 1U;
+		}
+		if( total != data_size + 1U ) {
+			std::terminate( );
+		}
+	} );
+	(void)daw::io::bench::run_mbs(
+	  "for_each_record_parallel", data_size, iterations, [&] {
+		  auto sv = daw::string_view( lines );
+		  auto r = daw::io::Reader( sv );
+		  auto total = std::atomic<std::size_t>( 0 );
+		  (void)daw::io::util::for_each_record_parallel(
+		    r, '\n', [&]( daw::string_view line ) {
+			    total.fetch_add( line.size( ) + 1U, std::memory_order_relaxed );
+		    } );
+		  if( total != data_size + 1U ) {
+			  std::terminate( );
+		  }
+	  } );
+}
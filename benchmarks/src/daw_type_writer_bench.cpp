@@ -0,0 +1,238 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_read_write.h>
+#include <daw/io/daw_type_writers.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	constexpr std::size_t value_count = 100'000;
+	constexpr std::size_t iterations = 10;
+
+	/// The digit generation used before digit counting, least significant
+	/// first into a stack buffer and then reversed
+	template<typename Integer>
+	std::size_t reverse_digits( std::span<char> buff, Integer value ) {
+		using unsigned_t = std::make_unsigned_t<Integer>;
+		char *const first = buff.data( );
+		char *ptr = first;
+		auto v = static_cast<unsigned_t>( value );
+		if constexpr( std::is_signed_v<Integer> ) {
+			if( value < 0 ) {
+				*ptr++ = '-';
+				v = static_cast<unsigned_t>( unsigned_t{ 0 } - v );
+			}
+		}
+		char *const num_start = ptr;
+		if( v == 0 ) {
+			*ptr++ = '0';
+		}
+		while( v >= 10U ) {
+			auto const tmp = static_cast<std::size_t>( v % 100U );
+			v = static_cast<unsigned_t>( v / 100U );
+			ptr[0] = static_cast<char>( '0' + tmp % 10U );
+			ptr[1] = static_cast<char>( '0' + tmp / 10U );
+			ptr += 2;
+		}
+		if( v > 0 ) {
+			*ptr++ = static_cast<char>( '0' + v );
+		}
+		std::reverse( num_start, ptr );
+		return static_cast<std::size_t>( ptr - first );
+	}
+
+	/// Values spread over the whole range of Integer, so every digit count
+	/// is present
+	template<typename Integer>
+	std::vector<Integer> make_integers( ) {
+		auto rng = std::mt19937_64( 42 );
+		auto result = std::vector<Integer>( value_count );
+		for( auto &v : result ) {
+			auto const shift = rng( ) % ( sizeof( Integer ) * 8U );
+			v = static_cast<Integer>( rng( ) >> ( 63U - shift ) );
+		}
+		return result;
+	}
+
+	template<typename Integer>
+	void bench_integers( char const *type_name ) {
+		auto const values = make_integers<Integer>( );
+		auto out = std::string( );
+		out.reserve( value_count * 24U );
+		auto w = daw::io::Writer( out );
+		auto const run = [&]( char const *title, auto const &write_one ) {
+			(void)daw::io::bench::run(
+			  std::string( title ) + " " + type_name, iterations, [&] {
+				  out.clear( );
+				  for( Integer v : values ) {
+					  (void)write_one( v );
+				  }
+				  daw::io::bench::do_not_optimize( out.size( ) );
+			  } );
+		};
+		constexpr std::size_t max_size = 24U;
+		run( "type_writer", [&]( Integer v ) {
+			return daw::io::type_writer::type_writer( w, v );
+		} );
+		run( "reverse digits", [&]( Integer v ) {
+			return daw::io::write_direct<max_size>( w, [&]( std::span<char> buff ) {
+				return reverse_digits( buff, v );
+			} );
+		} );
+		run( "std::to_chars", [&]( Integer v ) {
+			return daw::io::write_direct<max_size>( w, [&]( std::span<char> buff ) {
+				auto const r =
+				  std::to_chars( buff.data( ), buff.data( ) + buff.size( ), v );
+				return static_cast<std::size_t>( r.ptr - buff.data( ) );
+			} );
+		} );
+	}
+
+	/// Metric like values, a mix of magnitudes and fractions
+	std::vector<double> make_doubles( ) {
+		auto rng = std::mt19937_64( 42 );
+		auto dist = std::lognormal_distribution<double>( 0.0, 6.0 );
+		auto result = std::vector<double>( value_count );
+		for( auto &d : result ) {
+			d = dist( rng );
+		}
+		return result;
+	}
+} // namespace
+
+int main( ) {
+	namespace tw = daw::io::type_writer;
+	std::printf( "%zu integers per op\n", value_count );
+	bench_integers<std::int8_t>( "int8_t" );
+	bench_integers<std::uint8_t>( "uint8_t" );
+	bench_integers<std::int16_t>( "int16_t" );
+	bench_integers<std::uint16_t>( "uint16_t" );
+	bench_integers<std::int32_t>( "int32_t" );
+	bench_integers<std::uint32_t>( "uint32_t" );
+	bench_integers<std::int64_t>( "int64_t" );
+	bench_integers<std::uint64_t>( "uint64_t" );
+
+	{
+		// A typical log line
+		auto out = std::string( );
+		auto w = daw::io::Writer( out );
+		auto const values = make_integers<std::uint32_t>( );
+		(void)daw::io::bench::run( "print log line", iterations, [&] {
+			out.clear( );
+			for( auto v : values ) {
+				(void)tw::print( w, "request {} took {}us status={}\n", v, v / 7U,
+				                 "ok" );
+			}
+			daw::io::bench::do_not_optimize( out.size( ) );
+		} );
+		(void)daw::io::bench::run( "write_all log line", iterations, [&] {
+			out.clear( );
+			for( auto v : values ) {
+				(void)tw::write_all( w, "request ", v, " took ", v / 7U,
+				                     "us status=", "ok", '\n' );
+			}
+			daw::io::bench::do_not_optimize( out.size( ) );
+		} );
+		(void)daw::io::bench::run( "print padded fields", iterations, [&] {
+			out.clear( );
+			for( auto v : values ) {
+				(void)tw::print( w, "{:>10} {:08x} {:<6}|\n", v, v, "ok" );
+			}
+			daw::io::bench::do_not_optimize( out.size( ) );
+		} );
+		(void)daw::io::bench::run( "snprintf padded fields", iterations, [&] {
+			out.clear( );
+			char buff[64];
+			for( auto v : values ) {
+				auto const sz = std::snprintf( buff, sizeof( buff ),
+				                               "%10u %08x %-6s|\n", v, v, "ok" );
+				out.append( buff, static_cast<std::size_t>( sz ) );
+			}
+			daw::io::bench::do_not_optimize( out.size( ) );
+		} );
+		// Responses built into new strings, where growth is the main cost.
+		// write_all reserves the total once, the appends grow as they go
+		auto const body = std::string( 2000, 'b' );
+		auto const header = std::string( 300, 'h' );
+		(void)daw::io::bench::run( "write_all response", iterations, [&] {
+			for( auto v : values ) {
+				auto resp = std::string( );
+				auto rw = daw::io::Writer( resp );
+				(void)tw::write_all( rw, "HTTP/1.1 200 OK\r\n", header, "\r\n",
+				                     "Content-Length: ", v, "\r\n\r\n", body );
+				daw::io::bench::do_not_optimize( resp.size( ) );
+			}
+		} );
+		(void)daw::io::bench::run( "append response", iterations, [&] {
+			for( auto v : values ) {
+				auto resp = std::string( );
+				resp += "HTTP/1.1 200 OK\r\n";
+				resp += header;
+				resp += "\r\n";
+				resp += "Content-Length: ";
+				resp += std::to_string( v );
+				resp += "\r\n\r\n";
+				resp += body;
+				daw::io::bench::do_not_optimize( resp.size( ) );
+			}
+		} );
+	}
+
+	auto const doubles = make_doubles( );
+	auto out = std::string( );
+	out.reserve( value_count * 32U );
+	auto w = daw::io::Writer( out );
+	std::printf( "%zu doubles per op\n", value_count );
+	(void)daw::io::bench::run( "type_writer double", iterations, [&] {
+		out.clear( );
+		for( double d : doubles ) {
+			(void)tw::type_writer( w, d );
+			(void)w.put( ' ' );
+		}
+		daw::io::bench::do_not_optimize( out.size( ) );
+	} );
+	(void)daw::io::bench::run( "type_writer fixed( double, 3 )", iterations,
+	                           [&] {
+		                           out.clear( );
+		                           for( double d : doubles ) {
+			                           (void)tw::type_writer( w, tw::fixed( d, 3 ) );
+			                           (void)w.put( ' ' );
+		                           }
+		                           daw::io::bench::do_not_optimize( out.size( ) );
+	                           } );
+	(void)daw::io::bench::run( "snprintf %.17g", iterations, [&] {
+		out.clear( );
+		char buff[32];
+		for( double d : doubles ) {
+			auto const sz = std::snprintf( buff, sizeof( buff ), "%.17g ", d );
+			out.append( buff, static_cast<std::size_t>( sz ) );
+		}
+		daw::io::bench::do_not_optimize( out.size( ) );
+	} );
+	(void)daw::io::bench::run( "std::ostringstream", iterations, [&] {
+		auto oss = std::ostringstream( );
+		oss.precision( 17 );
+		for( double d : doubles ) {
+			oss << d << ' ';
+		}
+		daw::io::bench::do_not_optimize( oss.str( ).size( ) );
+	} );
+}
@@ -0,0 +1,45 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#include "daw_io_bench.h"
+
+#include <daw/io/daw_write_stream.h>
+
+#include <cstddef>
+#include <exception>
+#include <string>
+
+namespace {
+	constexpr std::size_t data_size = 16U * 1024U * 1024U;
+	constexpr std::size_t iterations = 4;
+} // namespace
+
+// write_ostream with and without a put area
+int main( ) {
+	auto const data = std::string( data_size, 'x' );
+	// One character per insertion, the worst case for the stream
+	auto out = std::string( );
+	out.reserve( data_size );
+	auto const run_ostream = [&]( char const *title, std::size_t buff_size ) {
+		(void)daw::io::bench::run_mbs( title, data_size, iterations, [&] {
+			out.clear( );
+			{
+				auto wo = daw::io::write_ostream( out, buff_size );
+				for( char c : data ) {
+					wo << c;
+				}
+			}
+			if( out.size( ) != data_size ) {
+				std::terminate( );
+			}
+		} );
+	};
+	run_ostream( "write_ostream unbuffered", 0 );
+	run_ostream( "write_ostream buffered",
+	             daw::io::write_streambuf::default_buffer_size );
+}
@@ -0,0 +1,169 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_read_proxy.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace daw::io {
+	/// @brief Split the data of a Reader into records ending with a delimiter.
+	/// The Reader is read in blocks into a buffer and records are found with
+	/// memchr, so there is no per byte work outside of the search.  A record
+	/// longer than the buffer grows it.  The returned views point into the
+	/// buffer and are valid until the next call to next( )
+	template<typename ReadableValue>
+	class DelimitedReader {
+		Reader<ReadableValue> m_reader;
+		std::unique_ptr<char[]> m_buffer;
+		std::size_t m_capacity;
+		std::size_t m_block_size;
+		// The unreturned data is [m_first, m_last), and [m_first, m_searched)
+		// is known not to have a delimiter
+		std::size_t m_first = 0;
+		std::size_t m_last = 0;
+		std::size_t m_searched = 0;
+		IOOpStatus m_status = IOOpStatus::Ok;
+		char m_delimiter;
+
+		/// @brief Read another block after the unreturned data.  When less than
+		/// half a block is free after it, the data is moved to the front, and the
+		/// buffer grows when that is not enough, so reads stay large
+		/// @return The number of bytes read
+		std::size_t fill( ) {
+			auto const min_free = std::max( m_block_size / 2U, std::size_t{ 1 } );
+			if( m_capacity - m_last < min_free ) {
+				auto const sz = m_last - m_first;
+				if( m_first > 0 ) {
+					std::memmove( m_buffer.get( ), m_buffer.get( ) + m_first, sz );
+					m_searched -= m_first;
+					m_first = 0;
+					m_last = sz;
+				}
+				if( m_capacity - m_last < min_free ) {
+					auto const new_capacity = m_capacity * 2U;
+					auto new_buffer =
+					  std::make_unique_for_overwrite<char[]>( new_capacity );
+					std::memcpy( new_buffer.get( ), m_buffer.get( ), sz );
+					m_buffer = std::move( new_buffer );
+					m_capacity = new_capacity;
+				}
+			}
+			auto const result = m_reader.read(
+			  std::span<char>( m_buffer.get( ) + m_last, m_capacity - m_last ) );
+			m_last += result.count;
+			m_status = result.status;
+			return result.count;
+		}
+
+	public:
+		/// @param block_size The initial size of the buffer, and the most read
+		/// from the Reader at once until a record needs more
+		explicit DelimitedReader( Reader<ReadableValue> reader,
+		                          char delimiter = '\n',
+		                          std::size_t block_size = 64U * 1024U )
+		  : m_reader( std::move( reader ) )
+		  , m_buffer( std::make_unique_for_overwrite<char[]>(
+		      std::max( block_size, std::size_t{ 1 } ) ) )
+		  , m_capacity( std::max( block_size, std::size_t{ 1 } ) )
+		  , m_block_size( m_capacity )
+		  , m_delimiter( delimiter ) {}
+
+		/// @return The next record without its delimiter.  The last record does
+		/// not need a delimiter.  nullopt once all records have been returned,
+		/// see status( ) for why
+		[[nodiscard]] std::optional<daw::string_view> next( ) {
+			while( true ) {
+				auto const *first = m_buffer.get( ) + m_first;
+				if( m_searched < m_last ) {
+					auto const *found = static_cast<char const *>(
+					  std::memchr( m_buffer.get( ) + m_searched, m_delimiter,
+					               m_last - m_searched ) );
+					if( found != nullptr ) {
+						auto const sz = static_cast<std::size_t>( found - first );
+						m_first += sz + 1U;
+						m_searched = m_first;
+						return daw::string_view( first, sz );
+					}
+					m_searched = m_last;
+				}
+				if( m_status != IOOpStatus::Ok ) {
+					if( m_first == m_last ) {
+						return std::nullopt;
+					}
+					auto const sz = m_last - m_first;
+					m_first = m_last;
+					m_searched = m_last;
+					if( m_status == IOOpStatus::Error ) {
+						// Do not pass off a partial record as a whole one
+						return std::nullopt;
+					}
+					return daw::string_view( first, sz );
+				}
+				if( fill( ) == 0 and m_status == IOOpStatus::Ok ) {
+					// The Reader has nothing available right now
+					return std::nullopt;
+				}
+			}
+		}
+
+		/// @return Ok while there may be more records, Eof after the Reader
+		/// reached its end or Error when a read failed
+		[[nodiscard]] IOOpStatus status( ) const {
+			return m_status;
+		}
+
+		[[nodiscard]] char delimiter( ) const {
+			return m_delimiter;
+		}
+	};
+	template<typename ReadableValue>
+	DelimitedReader( Reader<ReadableValue> ) -> DelimitedReader<ReadableValue>;
+	template<typename ReadableValue>
+	DelimitedReader( Reader<ReadableValue>, char )
+	  -> DelimitedReader<ReadableValue>;
+	template<typename ReadableValue>
+	DelimitedReader( Reader<ReadableValue>, char, std::size_t )
+	  -> DelimitedReader<ReadableValue>;
+
+	/// @brief A DelimitedReader of '\n' terminated lines that also removes a
+	/// '\r' before the '\n'
+	template<typename ReadableValue>
+	class LineReader : DelimitedReader<ReadableValue> {
+	public:
+		explicit LineReader( Reader<ReadableValue> reader,
+		                     std::size_t block_size = 64U * 1024U )
+		  : DelimitedReader<ReadableValue>( std::move( reader ), '\n',
+		                                    block_size ) {}
+
+		/// @return The next line without its line ending
+		[[nodiscard]] std::optional<daw::string_view> next( ) {
+			auto result = DelimitedReader<ReadableValue>::next( );
+			if( result and not result->empty( ) and result->back( ) == '\r' ) {
+				return daw::string_view( result->data( ), result->size( ) - 1U );
+			}
+			return result;
+		}
+
+		using DelimitedReader<ReadableValue>::status;
+	};
+	template<typename ReadableValue>
+	LineReader( Reader<ReadableValue> ) -> LineReader<ReadableValue>;
+	template<typename ReadableValue>
+	LineReader( Reader<ReadableValue>, std::size_t ) -> LineReader<ReadableValue>;
+} // namespace daw::io
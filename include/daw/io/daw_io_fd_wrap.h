@@ -8,10 +8,29 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 namespace daw::io {
 	struct fd_wrap_t {
 		int value;
 		constexpr fd_wrap_t( int fd ) noexcept
 		  : value( fd ) {}
 	};
+
+	/// @brief A file descriptor with its own position, read and written with
+	/// pread/pwrite.  The descriptor's shared file offset is neither used nor
+	/// changed, so many fd_at_offset's can use one descriptor concurrently from
+	/// different threads
+	struct fd_at_offset {
+		int value;
+		std::uint64_t offset = 0;
+		/// One past the last byte that can be read or written
+		std::uint64_t end = std::numeric_limits<std::uint64_t>::max( );
+
+		/// @return The bytes left before end
+		[[nodiscard]] constexpr std::uint64_t remaining( ) const noexcept {
+			return offset < end ? end - offset : 0;
+		}
+	};
 } // namespace daw::io
@@ -0,0 +1,295 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#if not __has_include( <linux/io_uring.h> )
+#error io_uring is only supported when linux/io_uring.h is present
+#endif
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace daw::io {
+	/// @brief Configuration of uring_reader/uring_writer
+	struct uring_options {
+		/// The number of buffers, and the most reads or writes in flight
+		unsigned queue_depth = 8U;
+		/// The size of each buffer
+		std::size_t buffer_size = 64U * 1024U;
+		/// Register the buffers with the kernel so they are not mapped for every
+		/// request.  Falls back to unregistered buffers when this fails, e.g. due
+		/// to RLIMIT_MEMLOCK
+		bool register_buffers = true;
+	};
+
+	namespace io_details {
+		/// The largest single read/write io_uring can describe
+		inline constexpr std::size_t uring_max_buffer_size = 1U << 30U;
+
+		/// @brief The parts of an io_uring_cqe the readers and writers use
+		struct uring_completion {
+			std::uint64_t user_data;
+			std::int32_t res;
+		};
+
+		/// @brief A minimal io_uring submission/completion queue pair using the
+		/// raw syscalls.  When the kernel does not support io_uring, or it is
+		/// blocked, is_open( ) is false
+		class uring {
+			int m_fd = -1;
+			void *m_sq_ring = MAP_FAILED;
+			std::size_t m_sq_ring_size = 0;
+			void *m_cq_ring = MAP_FAILED;
+			std::size_t m_cq_ring_size = 0;
+			::io_uring_sqe *m_sqes = nullptr;
+			std::size_t m_sqes_size = 0;
+			unsigned *m_sq_tail = nullptr;
+			unsigned m_sq_mask = 0;
+			unsigned *m_sq_array = nullptr;
+			unsigned m_sq_entries = 0;
+			unsigned *m_cq_head = nullptr;
+			unsigned *m_cq_tail = nullptr;
+			unsigned m_cq_mask = 0;
+			::io_uring_cqe *m_cqes = nullptr;
+			unsigned m_to_submit = 0;
+
+			template<typename T>
+			[[nodiscard]] static T *at( void *base, std::uint32_t offset ) {
+				return reinterpret_cast<T *>( static_cast<char *>( base ) + offset );
+			}
+
+			[[nodiscard]] int enter( unsigned to_submit, unsigned min_complete ) {
+				auto const flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0U;
+				return static_cast<int>( ::syscall( __NR_io_uring_enter, m_fd,
+				                                    to_submit, min_complete, flags,
+				                                    nullptr, 0 ) );
+			}
+
+			void close( ) {
+				if( m_sqes != nullptr ) {
+					::munmap( m_sqes, m_sqes_size );
+				}
+				if( m_cq_ring != MAP_FAILED and m_cq_ring != m_sq_ring ) {
+					::munmap( m_cq_ring, m_cq_ring_size );
+				}
+				if( m_sq_ring != MAP_FAILED ) {
+					::munmap( m_sq_ring, m_sq_ring_size );
+				}
+				if( m_fd >= 0 ) {
+					// Closing the ring waits for, or cancels, the requests in flight
+					::close( m_fd );
+				}
+				m_fd = -1;
+				m_sq_ring = MAP_FAILED;
+				m_cq_ring = MAP_FAILED;
+				m_sqes = nullptr;
+			}
+
+		public:
+			explicit uring( unsigned entries ) {
+				::io_uring_params params{ };
+				m_fd = static_cast<int>(
+				  ::syscall( __NR_io_uring_setup, std::max( entries, 1U ), &params ) );
+				if( m_fd < 0 ) {
+					return;
+				}
+				m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+				m_cq_ring_size =
+				  params.cq_off.cqes + params.cq_entries * sizeof( ::io_uring_cqe );
+				bool const single_mmap = ( params.features & IORING_FEAT_SINGLE_MMAP ) != 0;
+				if( single_mmap ) {
+					m_sq_ring_size = m_cq_ring_size =
+					  std::max( m_sq_ring_size, m_cq_ring_size );
+				}
+				m_sq_ring = ::mmap( nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE,
+				                    MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING );
+				if( m_sq_ring == MAP_FAILED ) {
+					close( );
+					return;
+				}
+				m_cq_ring = single_mmap ? m_sq_ring
+				                        : ::mmap( nullptr, m_cq_ring_size,
+				                                  PROT_READ | PROT_WRITE,
+				                                  MAP_SHARED | MAP_POPULATE, m_fd,
+				                                  IORING_OFF_CQ_RING );
+				m_sqes_size = params.sq_entries * sizeof( ::io_uring_sqe );
+				void *sqes = ::mmap( nullptr, m_sqes_size, PROT_READ | PROT_WRITE,
+				                     MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES );
+				if( m_cq_ring == MAP_FAILED or sqes == MAP_FAILED ) {
+					close( );
+					return;
+				}
+				m_sqes = static_cast<::io_uring_sqe *>( sqes );
+				m_sq_tail = at<unsigned>( m_sq_ring, params.sq_off.tail );
+				m_sq_mask = *at<unsigned>( m_sq_ring, params.sq_off.ring_mask );
+				m_sq_array = at<unsigned>( m_sq_ring, params.sq_off.array );
+				m_sq_entries = params.sq_entries;
+				m_cq_head = at<unsigned>( m_cq_ring, params.cq_off.head );
+				m_cq_tail = at<unsigned>( m_cq_ring, params.cq_off.tail );
+				m_cq_mask = *at<unsigned>( m_cq_ring, params.cq_off.ring_mask );
+				m_cqes = at<::io_uring_cqe>( m_cq_ring, params.cq_off.cqes );
+			}
+
+			uring( uring const & ) = delete;
+			uring &operator=( uring const & ) = delete;
+
+			~uring( ) {
+				close( );
+			}
+
+			[[nodiscard]] bool is_open( ) const {
+				return m_fd >= 0;
+			}
+
+			/// @brief The number of submission entries, the most requests that can
+			/// be queued before submit( )
+			[[nodiscard]] unsigned entries( ) const {
+				return m_sq_entries;
+			}
+
+			/// @brief Register buffers for use with the *_FIXED operations, where
+			/// buf_index is the position in buffers
+			[[nodiscard]] bool register_buffers( std::span<::iovec const> buffers ) {
+				return ::syscall( __NR_io_uring_register, m_fd,
+				                  IORING_REGISTER_BUFFERS, buffers.data( ),
+				                  static_cast<unsigned>( buffers.size( ) ) ) == 0;
+			}
+
+			/// @brief Queue a read or write of buff at offset, -1 meaning the file
+			/// position.  The request is sent to the kernel by the next submit
+			/// @param fixed_index The registered buffer index, or -1 if buff is not a
+			/// registered buffer
+			void queue_rw( std::uint8_t opcode, int fd, void const *buff,
+			               std::size_t len, std::int64_t offset, int fixed_index,
+			               std::uint64_t user_data ) {
+				auto const tail = *m_sq_tail + m_to_submit;
+				auto const idx = tail & m_sq_mask;
+				::io_uring_sqe &sqe = m_sqes[idx];
+				std::memset( &sqe, 0, sizeof( sqe ) );
+				sqe.opcode = opcode;
+				sqe.fd = fd;
+				sqe.addr = reinterpret_cast<std::uintptr_t>( buff );
+				sqe.len = static_cast<std::uint32_t>( len );
+				sqe.off = static_cast<std::uint64_t>( offset );
+				if( fixed_index >= 0 ) {
+					sqe.buf_index = static_cast<std::uint16_t>( fixed_index );
+				}
+				sqe.user_data = user_data;
+				m_sq_array[idx] = idx;
+				++m_to_submit;
+			}
+
+			/// @brief Send the queued requests to the kernel and wait until at
+			/// least min_complete completions are available
+			/// @return false on failure, with errno set
+			[[nodiscard]] bool submit( unsigned min_complete = 0 ) {
+				if( m_to_submit > 0 ) {
+					std::atomic_ref<unsigned>( *m_sq_tail )
+					  .store( *m_sq_tail + m_to_submit, std::memory_order_release );
+				}
+				auto to_submit = m_to_submit;
+				m_to_submit = 0;
+				while( true ) {
+					int const result = enter( to_submit, min_complete );
+					if( result >= 0 ) {
+						to_submit -= std::min( to_submit, static_cast<unsigned>( result ) );
+						if( to_submit == 0 ) {
+							return true;
+						}
+						continue;
+					}
+					if( errno != EINTR ) {
+						return false;
+					}
+				}
+			}
+
+			/// @return The next completion, if any, without waiting
+			[[nodiscard]] std::optional<uring_completion> pop_completion( ) {
+				auto const head = *m_cq_head;
+				auto const tail =
+				  std::atomic_ref<unsigned>( *m_cq_tail ).load( std::memory_order_acquire );
+				if( head == tail ) {
+					return std::nullopt;
+				}
+				::io_uring_cqe const &cqe = m_cqes[head & m_cq_mask];
+				auto const result = uring_completion{ cqe.user_data, cqe.res };
+				std::atomic_ref<unsigned>( *m_cq_head )
+				  .store( head + 1, std::memory_order_release );
+				return result;
+			}
+		};
+
+		/// @brief queue_depth equally sized buffers in one allocation, optionally
+		/// registered with a ring.  It must outlive the requests using it, so
+		/// declare it before the uring in a class
+		class uring_buffers {
+			std::size_t m_buffer_size;
+			std::size_t m_count;
+			std::unique_ptr<char[]> m_memory;
+			bool m_fixed = false;
+
+		public:
+			explicit uring_buffers( uring_options const &opts )
+			  : m_buffer_size(
+			      std::clamp( opts.buffer_size, std::size_t{ 1 }, uring_max_buffer_size ) )
+			  , m_count( std::max( opts.queue_depth, 1U ) )
+			  , m_memory(
+			      std::make_unique_for_overwrite<char[]>( m_buffer_size * m_count ) ) {}
+
+			/// @brief Register the buffers with ring so that the *_FIXED operations
+			/// can be used
+			/// @return false when the kernel refused, the buffers remain usable with
+			/// the non fixed operations
+			bool register_with( uring &ring ) {
+				auto iovs = std::vector<::iovec>( m_count );
+				for( std::size_t n = 0; n < m_count; ++n ) {
+					iovs[n].iov_base = data( n );
+					iovs[n].iov_len = m_buffer_size;
+				}
+				m_fixed = ring.register_buffers( iovs );
+				return m_fixed;
+			}
+
+			[[nodiscard]] char *data( std::size_t idx ) const {
+				return m_memory.get( ) + idx * m_buffer_size;
+			}
+
+			[[nodiscard]] std::size_t buffer_size( ) const {
+				return m_buffer_size;
+			}
+
+			[[nodiscard]] std::size_t count( ) const {
+				return m_count;
+			}
+
+			[[nodiscard]] bool is_fixed( ) const {
+				return m_fixed;
+			}
+
+			/// @return The registered buffer index for queue_rw
+			[[nodiscard]] int fixed_index( std::size_t idx ) const {
+				return m_fixed ? static_cast<int>( idx ) : -1;
+			}
+		};
+	} // namespace io_details
+} // namespace daw::io
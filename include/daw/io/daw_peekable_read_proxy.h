@@ -11,11 +11,16 @@
 #include "daw_read_proxy.h"
 #include "daw_write_proxy.h"
 
+#include <daw/daw_algorithm.h>
 #include <daw/daw_contiguous_view.h>
-#include <daw/vector.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
 
 namespace daw::io {
 	struct PeekResult {
@@ -23,91 +28,254 @@ namespace daw::io {
 		daw::contiguous_view<std::byte const> buffer;
 	};
 
+	/// @brief Wrap a Reader so that data can be looked at before it is read.
+	/// Peeked bytes are kept in a buffer that is reused as they are read or
+	/// consumed, so its size is that of the largest peek, not of all the data
+	/// read.  It never grows past max_peek_size( ).
+	///
+	/// The views returned by peek, peek_until and read_view point into the
+	/// buffer.  They stay valid, including after consume or skip of their
+	/// bytes, until the next call of peek, peek_until, read_view, read, get,
+	/// skip past the peeked bytes or clear
 	template<typename ReadableValue>
 	class PeekableReader {
-		daw::vector<std::byte> buffer{ };
+		std::unique_ptr<std::byte[]> buffer{ };
+		std::size_t buffer_capacity = 0;
+		std::size_t max_capacity = std::numeric_limits<std::size_t>::max( );
+		// The buffered bytes are [idx_first, idx_last)
 		std::size_t idx_first = 0;
+		std::size_t idx_last = 0;
+		// Eof or Error once the Reader has returned it, it is not read again
+		IOOpStatus reader_status = IOOpStatus::Ok;
 		Reader<ReadableValue> reader;
 
+		/// The least peek_until and skip read at a time
+		static constexpr std::size_t min_peek_growth = 256U;
+
 		inline std::size_t buffer_size( ) const {
-			assert( idx_first <= buffer.size( ) );
-			return buffer.size( ) - idx_first;
+			assert( idx_first <= idx_last );
+			return idx_last - idx_first;
 		}
 
 		daw::contiguous_view<std::byte> read_buffer( std::size_t n ) {
-			auto const amount =
-			  static_cast<std::ptrdiff_t>( std::min( n, buffer_size( ) ) );
-			auto first =
-			  std::next( buffer.data( ), static_cast<std::ptrdiff_t>( idx_first ) );
-			auto last = std::next( first, amount );
+			auto *first = buffer.get( ) + idx_first;
+			auto *last = first + std::min( n, buffer_size( ) );
 			return daw::contiguous_view( first, last );
 		}
 
 		daw::contiguous_view<std::byte> pop_buffer( std::size_t n ) {
 			auto result = read_buffer( n );
-			idx_first += result.size( );
+			(void)consume( result.size( ) );
+			return result;
+		}
+
+		/// @brief Read from the Reader, unless it already returned Eof or Error
+		template<typename Byte>
+		IOOpResult read_reader( std::span<Byte> sp ) {
+			if( reader_status != IOOpStatus::Ok ) {
+				return { reader_status, 0 };
+			}
+			auto const result = reader.read( sp );
+			reader_status = result.status;
 			return result;
 		}
 
+		/// @brief Make room for n buffered bytes after idx_first.  The buffered
+		/// bytes are moved to the front first, and the buffer only grows when
+		/// that is not enough
+		void reserve( std::size_t n ) {
+			assert( n <= max_capacity );
+			if( buffer_capacity - idx_first >= n ) {
+				return;
+			}
+			auto const sz = buffer_size( );
+			if( buffer_capacity >= n ) {
+				std::memmove( buffer.get( ), buffer.get( ) + idx_first, sz );
+			} else {
+				auto const new_capacity =
+				  std::clamp( buffer_capacity * 2U, n, max_capacity );
+				auto new_buffer =
+				  std::make_unique_for_overwrite<std::byte[]>( new_capacity );
+				if( sz > 0 ) {
+					std::memcpy( new_buffer.get( ), buffer.get( ) + idx_first, sz );
+				}
+				buffer = std::move( new_buffer );
+				buffer_capacity = new_capacity;
+			}
+			idx_first = 0;
+			idx_last = sz;
+		}
+
 	public:
 		explicit constexpr PeekableReader( Reader<ReadableValue> r ) noexcept
 		  : reader( std::move( r ) ) {}
 
+		/// @param max_peek The most bytes that can be peeked at once, larger
+		/// peeks return max_peek bytes.  Use it to bound the memory used
+		constexpr PeekableReader( Reader<ReadableValue> r,
+		                          std::size_t max_peek ) noexcept
+		  : max_capacity( std::max( max_peek, std::size_t{ 1 } ) )
+		  , reader( std::move( r ) ) {}
+
+		/// @brief Read the peeked bytes, or from the Reader when there are none.
+		/// A read never mixes the two, so it can return fewer bytes than
+		/// requested while peeked bytes remain
 		template<typename Byte>
-		[[nodiscard]] constexpr IOOpResult read( std::span<Byte> sp ) {
+		[[nodiscard]] IOOpResult read( std::span<Byte> sp ) {
 			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
-			auto *first = sp.data( );
-			auto *const last = daw::data_end( sp );
 			if( auto buff = pop_buffer( sp.size( ) ); not buff.empty( ) ) {
-				first = daw::algorithm::convert_copy_n<Byte>( buff.data( ), first,
-				                                              buff.size( ) );
-			}
-			if( first == last ) {
-				return { IOOpStatus::Ok, sp.size( ) };
+				(void)daw::algorithm::convert_copy_n<Byte>( buff.data( ), sp.data( ),
+				                                            buff.size( ) );
+				return { IOOpStatus::Ok, buff.size( ) };
 			}
-			sp = std::span<Byte>( first, last );
-			return reader.read( sp );
+			return read_reader( sp );
 		}
 
 		template<typename Byte>
-		[[nodiscard]] constexpr IOOpResult get( Byte &c ) {
+		[[nodiscard]] IOOpResult get( Byte &c ) {
 			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
 			if( auto buff = pop_buffer( 1 ); not buff.empty( ) ) {
 				c = static_cast<Byte>( buff[0] );
 				return { IOOpStatus::Ok, 1 };
 			}
-			return reader.get( c );
+			if( reader_status != IOOpStatus::Ok ) {
+				return { reader_status, 0 };
+			}
+			auto const result = reader.get( c );
+			reader_status = result.status;
+			return result;
+		}
+
+		/// @brief Drop up to n of the peeked bytes without copying them
+		/// @return The number of bytes dropped
+		constexpr std::size_t consume( std::size_t n ) {
+			n = std::min( n, buffer_size( ) );
+			idx_first += n;
+			if( idx_first == idx_last ) {
+				// Start over at the front so the next peek does not need to move
+				// anything
+				idx_first = 0;
+				idx_last = 0;
+			}
+			return n;
 		}
 
 		[[nodiscard]] constexpr std::size_t max_peek_size( ) const {
-			return buffer.max_size( );
+			return max_capacity;
+		}
+
+		/// @return The size of the buffer holding peeked bytes
+		[[nodiscard]] constexpr std::size_t capacity( ) const {
+			return buffer_capacity;
 		}
 
-		constexpr void clear( ) {
-			buffer.clear( );
+		/// @brief Drop the peeked bytes and release the buffer
+		void clear( ) {
+			buffer.reset( );
+			buffer_capacity = 0;
 			idx_first = 0;
+			idx_last = 0;
 		}
 
-		[[nodiscard]] constexpr PeekResult peek( std::size_t sz ) {
+		/// @brief Look at the next sz bytes, reading more when fewer are
+		/// buffered.  The view is valid until the next call of a non-const
+		/// member
+		[[nodiscard]] PeekResult peek( std::size_t sz ) {
+			sz = std::min( sz, max_capacity );
 			auto read_status = IOOpStatus::Ok;
 			if( buffer_size( ) < sz ) {
-				auto append_sz = sz - buffer_size( );
-				(void)buffer.append_and_overwrite(
-				  append_sz, [&]( std::byte *ptr, std::size_t size ) {
-					  auto bsp = std::span<std::byte>( ptr, size );
-					  auto result = reader.read( bsp );
-					  read_status = result.status;
-					  return result.count;
-				  } );
+				reserve( sz );
+				auto bsp =
+				  std::span<std::byte>( buffer.get( ) + idx_last, sz - buffer_size( ) );
+				auto result = read_reader( bsp );
+				read_status = result.status;
+				idx_last += result.count;
 			}
 			auto buff = read_buffer( sz );
 			return { IOOpResult{ read_status, buff.size( ) }, buff };
 		}
 
-		[[nodiscard]] constexpr PeekResult peek( ) {
+		[[nodiscard]] PeekResult peek( ) {
 			return peek( buffer_size( ) );
 		}
+
+		/// @brief Look at the bytes up to and including the next delimiter,
+		/// reading more as needed
+		/// @return When found the view ends with delimiter.  Otherwise it is all
+		/// the bytes peeked, with the status Eof or Error from the Reader, or Ok
+		/// when max_peek_size( ) bytes have no delimiter
+		template<typename Byte>
+		[[nodiscard]] PeekResult peek_until( Byte delimiter ) {
+			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
+			auto const delim = static_cast<unsigned char>( delimiter );
+			auto status = IOOpStatus::Ok;
+			std::size_t searched = 0;
+			while( true ) {
+				if( buffer_size( ) > searched ) {
+					auto const *first = buffer.get( ) + idx_first;
+					auto const *found = static_cast<std::byte const *>( std::memchr(
+					  first + searched, delim, buffer_size( ) - searched ) );
+					if( found != nullptr ) {
+						auto const sz = static_cast<std::size_t>( found - first ) + 1U;
+						return { IOOpResult{ IOOpStatus::Ok, sz }, read_buffer( sz ) };
+					}
+				}
+				searched = buffer_size( );
+				if( status != IOOpStatus::Ok or searched == max_capacity ) {
+					return { IOOpResult{ status, searched }, read_buffer( searched ) };
+				}
+				// Ask for twice as much each time so that long lines take few reads
+				auto const want = std::min(
+				  max_capacity, std::max( searched * 2U, searched + min_peek_growth ) );
+				status = peek( want ).io_result.status;
+				if( status == IOOpStatus::Ok and buffer_size( ) == searched ) {
+					// The Reader has nothing available right now
+					return { IOOpResult{ status, searched }, read_buffer( searched ) };
+				}
+			}
+		}
+
+		/// @brief Read up to n bytes without copying them
+		/// @return A view of the bytes read, see peek for its lifetime
+		[[nodiscard]] PeekResult read_view( std::size_t n ) {
+			auto result = peek( n );
+			(void)consume( result.buffer.size( ) );
+			return result;
+		}
+
+		/// @brief Advance past n bytes, the peeked ones first and then reading
+		/// and discarding from the Reader
+		/// @return The number of bytes skipped, with the status of the last read
+		IOOpResult skip( std::size_t n ) {
+			std::size_t skipped = consume( n );
+			while( skipped < n ) {
+				auto const chunk = std::max( buffer_capacity, min_peek_growth );
+				auto const pr = peek( std::min( n - skipped, chunk ) );
+				skipped += consume( pr.buffer.size( ) );
+				if( pr.io_result.status != IOOpStatus::Ok ) {
+					return { pr.io_result.status, skipped };
+				}
+			}
+			return { IOOpStatus::Ok, skipped };
+		}
 	};
 	template<typename ReadableValue>
 	PeekableReader( Reader<ReadableValue> ) -> PeekableReader<ReadableValue>;
+	template<typename ReadableValue>
+	PeekableReader( Reader<ReadableValue>, std::size_t )
+	  -> PeekableReader<ReadableValue>;
+
+	template<typename ReadableValue>
+	struct ReadableInput<PeekableReader<ReadableValue>> {
+		template<typename Byte>
+		static IOOpResult read( PeekableReader<ReadableValue> &pr,
+		                        std::span<Byte> buff ) {
+			return pr.read( buff );
+		}
+
+		template<typename Byte>
+		static IOOpResult get( PeekableReader<ReadableValue> &pr, Byte &b ) {
+			return pr.get( b );
+		}
+	};
 } // namespace daw::io
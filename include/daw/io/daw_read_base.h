@@ -10,16 +10,22 @@
 
 #include "daw_io_base.h"
 
+#include <daw/cpp_17.h>
 #include <daw/daw_always_false.h>
 #include <daw/daw_string_view.h>
 
 #include <cstddef>
 #include <optional>
 #include <span>
+#include <utility>
 
 namespace daw::io {
 	// Base trait for ReadableInput.  Specializations must have the methods
-	// declared here
+	// declared here.
+	//
+	// Sources whose data is already in memory can optionally provide
+	//   static daw::string_view borrow( T &, std::size_t n )
+	// that advances by up to n bytes and returns a view of them without copying
 	template<typename T>
 	struct ReadableInput {
 		[[noreturn]] static IOOpResult read( T &, std::span<char> ) {
@@ -42,4 +48,31 @@ namespace daw::io {
 			               "ReadableInput not specialized for type" );
 		}
 	};
+
+	namespace io_details {
+		template<typename T>
+		using has_borrow_test = decltype( ReadableInput<T>::borrow(
+		  std::declval<T &>( ), std::declval<std::size_t>( ) ) );
+	} // namespace io_details
+
+	template<typename T>
+	inline constexpr bool has_borrow_v =
+	  daw::is_detected_v<io_details::has_borrow_test, T>;
+
+	namespace io_details {
+		/// @brief Advance readable_value by up to n bytes and return a view of
+		/// them without copying
+		/// @return The bytes, or an empty view when unsupported or at the end
+		template<typename T>
+		[[nodiscard]] constexpr daw::string_view borrow( T &readable_value,
+		                                                 std::size_t n ) {
+			if constexpr( has_borrow_v<T> ) {
+				return ReadableInput<T>::borrow( readable_value, n );
+			} else {
+				(void)readable_value;
+				(void)n;
+				return { };
+			}
+		}
+	} // namespace io_details
 } // namespace daw::io
@@ -16,14 +16,19 @@
 #include <daw/daw_likely.h>
 #include <daw/daw_string_view.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <optional>
 #include <span>
+#include <vector>
 
 #if not __has_include( <unistd.h> )
 #error fd is only supported when unistd.h is present
 #endif
+#include <sys/stat.h>
 #include <unistd.h>
 
 namespace daw::io {
@@ -36,8 +41,9 @@ namespace daw::io {
 				return { IOOpStatus::Ok, 0 };
 			}
 			auto result = ::read( fd.value, buff.data( ), buff.size( ) );
-			if( result == buff.size( ) ) {
-				return { IOOpStatus::Ok, result };
+			if( result > 0 ) {
+				// Short reads are normal for pipes, sockets and terminals
+				return { IOOpStatus::Ok, static_cast<std::size_t>( result ) };
 			}
 			if( result == 0 ) {
 				return { IOOpStatus::Eof, 0 };
@@ -54,4 +60,68 @@ namespace daw::io {
 			                            std::span<Byte>( std::addressof( c ), 1 ) );
 		}
 	};
+
+	template<>
+	struct ReadableInput<fd_at_offset> {
+		template<typename Byte>
+		static IOOpResult read( fd_at_offset &fd, std::span<Byte> buff ) {
+			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
+			if( buff.empty( ) ) {
+				return { IOOpStatus::Ok, 0 };
+			}
+			auto const len = static_cast<std::size_t>(
+			  std::min<std::uint64_t>( buff.size( ), fd.remaining( ) ) );
+			if( len == 0 ) {
+				return { IOOpStatus::Eof, 0 };
+			}
+			while( true ) {
+				auto const result = ::pread( fd.value, buff.data( ), len,
+				                             static_cast<::off_t>( fd.offset ) );
+				if( result > 0 ) {
+					fd.offset += static_cast<std::uint64_t>( result );
+					return { IOOpStatus::Ok, static_cast<std::size_t>( result ) };
+				}
+				if( result == 0 ) {
+					return { IOOpStatus::Eof, 0 };
+				}
+				if( errno != EINTR ) {
+					return { IOOpStatus::Error, 0 };
+				}
+			}
+		}
+
+		template<typename Byte>
+		static IOOpResult get( fd_at_offset &fd, Byte &c ) {
+			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
+			return ReadableInput::read( fd,
+			                            std::span<Byte>( std::addressof( c ), 1 ) );
+		}
+	};
+
+	/// @brief Split the file open at fd into count ranges of about equal size,
+	/// e.g. to give each thread its own Reader over one descriptor
+	/// @return The ranges in file order, or an empty vector when the size of
+	/// the file cannot be determined.  There are fewer than count ranges when
+	/// the file is smaller than count bytes
+	[[nodiscard]] inline std::vector<fd_at_offset> split_file( fd_wrap_t fd,
+	                                                           std::size_t count ) {
+		struct ::stat st { };
+		if( count == 0 or ::fstat( fd.value, &st ) != 0 or st.st_size < 0 ) {
+			return { };
+		}
+		auto const size = static_cast<std::uint64_t>( st.st_size );
+		auto const parts = std::max<std::uint64_t>(
+		  std::min<std::uint64_t>( count, size ), std::uint64_t{ 1 } );
+		// The first size % parts ranges get an extra byte
+		auto const range_begin = [&]( std::uint64_t n ) {
+			return n * ( size / parts ) + std::min( n, size % parts );
+		};
+		auto result = std::vector<fd_at_offset>( );
+		result.reserve( static_cast<std::size_t>( parts ) );
+		for( std::uint64_t n = 0; n < parts; ++n ) {
+			result.push_back(
+			  fd_at_offset{ fd.value, range_begin( n ), range_begin( n + 1 ) } );
+		}
+		return result;
+	}
 } // namespace daw::io
@@ -0,0 +1,213 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_fd_wrap.h"
+#include "daw_read_base.h"
+
+#include <daw/daw_algorithm.h>
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <utility>
+
+#if not __has_include( <sys/mman.h> )
+#error mmap is only supported when sys/mman.h is present
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace daw::io {
+	/// @brief A read only memory mapping of a whole file.  Reads copy out of
+	/// the mapping and borrow( n ) returns a view into it without copying.
+	/// When construction fails, is_open( ) is false and reads return
+	/// IOOpStatus::Error
+	class mmap_reader {
+		char const *m_data = nullptr;
+		std::size_t m_size = 0;
+		std::size_t m_pos = 0;
+		bool m_is_open = false;
+
+		void map_fd( int fd ) {
+			struct ::stat st { };
+			if( ::fstat( fd, &st ) != 0 or st.st_size < 0 ) {
+				return;
+			}
+			m_size = static_cast<std::size_t>( st.st_size );
+			if( m_size == 0 ) {
+				m_is_open = true;
+				return;
+			}
+			void *ptr = ::mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+			if( ptr == MAP_FAILED ) {
+				m_size = 0;
+				return;
+			}
+			m_data = static_cast<char const *>( ptr );
+			m_is_open = true;
+		}
+
+		bool advise( std::size_t offset, std::size_t len, int advice ) const {
+			if( m_data == nullptr or len == 0 ) {
+				return m_is_open;
+			}
+			// madvise requires a page aligned start
+			auto const page_size = static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+			auto const aligned = offset - ( offset % page_size );
+			return ::madvise( const_cast<char *>( m_data + aligned ),
+			                  len + ( offset - aligned ), advice ) == 0;
+		}
+
+	public:
+		explicit mmap_reader( ) = default;
+
+		/// @brief Map the file at path
+		explicit mmap_reader( std::filesystem::path const &path ) {
+			int const fd = ::open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+			if( fd < 0 ) {
+				return;
+			}
+			map_fd( fd );
+			// The mapping keeps the file alive
+			::close( fd );
+		}
+
+		/// @brief Map the whole file open at fd.  The fd remains owned by the
+		/// caller and can be closed afterwards
+		explicit mmap_reader( fd_wrap_t fd ) {
+			map_fd( fd.value );
+		}
+
+		mmap_reader( mmap_reader const & ) = delete;
+		mmap_reader &operator=( mmap_reader const & ) = delete;
+
+		mmap_reader( mmap_reader &&other ) noexcept
+		  : m_data( std::exchange( other.m_data, nullptr ) )
+		  , m_size( std::exchange( other.m_size, 0 ) )
+		  , m_pos( std::exchange( other.m_pos, 0 ) )
+		  , m_is_open( std::exchange( other.m_is_open, false ) ) {}
+
+		mmap_reader &operator=( mmap_reader &&rhs ) noexcept {
+			if( this != &rhs ) {
+				close( );
+				m_data = std::exchange( rhs.m_data, nullptr );
+				m_size = std::exchange( rhs.m_size, 0 );
+				m_pos = std::exchange( rhs.m_pos, 0 );
+				m_is_open = std::exchange( rhs.m_is_open, false );
+			}
+			return *this;
+		}
+
+		~mmap_reader( ) {
+			close( );
+		}
+
+		void close( ) {
+			if( m_data != nullptr ) {
+				::munmap( const_cast<char *>( m_data ), m_size );
+			}
+			m_data = nullptr;
+			m_size = 0;
+			m_pos = 0;
+			m_is_open = false;
+		}
+
+		[[nodiscard]] bool is_open( ) const {
+			return m_is_open;
+		}
+
+		/// @return The size of the whole file
+		[[nodiscard]] std::size_t size( ) const {
+			return m_size;
+		}
+
+		[[nodiscard]] std::size_t position( ) const {
+			return m_pos;
+		}
+
+		[[nodiscard]] std::size_t remaining( ) const {
+			return m_size - m_pos;
+		}
+
+		/// @return A view of the whole mapping, independent of the position
+		[[nodiscard]] daw::string_view view( ) const {
+			return daw::string_view( m_data, m_size );
+		}
+
+		/// @brief Advance the position by up to n bytes without copying them
+		/// @return A view of the bytes consumed.  It is valid for the lifetime of
+		/// the mapping
+		[[nodiscard]] daw::string_view borrow( std::size_t n ) {
+			n = std::min( n, remaining( ) );
+			auto result = daw::string_view( m_data + m_pos, n );
+			m_pos += n;
+			return result;
+		}
+
+		/// @brief Tell the kernel the mapping will be read sequentially, so it
+		/// reads ahead aggressively and frees pages behind the reader
+		bool advise_sequential( ) const {
+			return advise( 0, m_size, MADV_SEQUENTIAL );
+		}
+
+		/// @brief Ask the kernel to start reading in the next n bytes from the
+		/// current position
+		bool advise_willneed( std::size_t n ) const {
+			return advise( m_pos, std::min( n, remaining( ) ), MADV_WILLNEED );
+		}
+
+		bool advise_willneed( ) const {
+			return advise_willneed( remaining( ) );
+		}
+
+		template<typename Byte>
+		IOOpResult read( std::span<Byte> buff ) {
+			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
+			if( not m_is_open ) {
+				return { IOOpStatus::Error, 0 };
+			}
+			if( remaining( ) == 0 ) {
+				return { IOOpStatus::Eof, 0 };
+			}
+			auto const sv = borrow( buff.size( ) );
+			(void)daw::algorithm::convert_copy_n<Byte>( sv.data( ), buff.data( ),
+			                                            sv.size( ) );
+			return { remaining( ) == 0 ? IOOpStatus::Eof : IOOpStatus::Ok,
+			         sv.size( ) };
+		}
+
+		template<typename Byte>
+		IOOpResult get( Byte &b ) {
+			return read( std::span<Byte>( std::addressof( b ), 1 ) );
+		}
+	};
+
+	template<>
+	struct ReadableInput<mmap_reader> {
+		template<typename Byte>
+		static IOOpResult read( mmap_reader &mr, std::span<Byte> buff ) {
+			return mr.read( buff );
+		}
+
+		template<typename Byte>
+		static IOOpResult get( mmap_reader &mr, Byte &b ) {
+			return mr.get( b );
+		}
+
+		static daw::string_view borrow( mmap_reader &mr, std::size_t n ) {
+			return mr.borrow( n );
+		}
+	};
+} // namespace daw::io
@@ -12,135 +12,128 @@
 
 #include <daw/daw_assume.h>
 #include <daw/daw_string_view.h>
-#include <daw/daw_unique_ptr.h>
 
+#include <cassert>
 #include <cstddef>
 #include <initializer_list>
+#include <memory>
 #include <span>
 
 namespace daw::io {
 
+	/// @brief A non-owning handle to a Readable.  It is trivially copyable and
+	/// the Readable must outlive it
 	template<typename Readable>
 	class Reader {
-		struct data_t {
-			Readable &readable_value;
-		};
-		daw::unique_ptr<data_t> data{ };
+		Readable *m_readable = nullptr;
 
 	public:
 		explicit Reader( ) = default;
-		explicit constexpr Reader( Readable &readable_value )
-		  : data( daw::make_unique<data_t>( readable_value ) ) {}
+		explicit constexpr Reader( Readable &readable_value ) noexcept
+		  : m_readable( std::addressof( readable_value ) ) {}
+
+		[[nodiscard]] constexpr Readable &readable( ) const noexcept {
+			assert( m_readable );
+			return *m_readable;
+		}
 
 		template<typename Byte>
 		[[nodiscard]] DAW_ATTRIB_INLINE constexpr IOOpResult
 		read( std::span<Byte> sp ) {
 			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
-			assert( data );
-			return ReadableInput<Readable>::read( data->readable_value, sp );
+			assert( m_readable );
+			return ReadableInput<Readable>::read( *m_readable, sp );
 		}
 
 		template<typename Byte>
 		[[nodiscard]] DAW_ATTRIB_INLINE constexpr IOOpResult get( Byte &c ) {
 			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
-			assert( data );
-			return ReadableInput<Readable>::get( data->readable_value, c );
+			assert( m_readable );
+			return ReadableInput<Readable>::get( *m_readable, c );
 		}
 	};
 	template<typename ReadableType>
 	Reader( ReadableType ) -> Reader<ReadableType>;
 
 	namespace io_details {
-		struct ReadProxyImpl {
-			explicit ReadProxyImpl( ) = default;
-			constexpr virtual ~ReadProxyImpl( ) = default;
-
-			virtual constexpr daw::unique_ptr<ReadProxyImpl> clone( ) const = 0;
-			virtual constexpr IOOpResult read( std::span<char> sp ) = 0;
-			virtual constexpr IOOpResult read( std::span<std::byte> sp ) = 0;
-			virtual constexpr IOOpResult get( char &c ) = 0;
-			virtual constexpr IOOpResult get( std::byte &b ) = 0;
+		/// @brief The operations of a ReadProxy.  There is one static instance per
+		/// Readable type, so a ReadProxy is a pointer to it and a pointer to the
+		/// Readable
+		struct read_proxy_vtable_t {
+			IOOpResult ( *read_chars )( void *, std::span<char> );
+			IOOpResult ( *read_bytes )( void *, std::span<std::byte> );
+			IOOpResult ( *get_char )( void *, char & );
+			IOOpResult ( *get_byte )( void *, std::byte & );
+			daw::string_view ( *borrow )( void *, std::size_t );
+			bool can_borrow;
 		};
 
-		namespace {
-			template<typename T>
-			class ReadProxyImplChild final : public ReadProxyImpl {
-				T &reader;
-
-			public:
-				explicit constexpr ReadProxyImplChild( T &readable_value )
-				  : reader( readable_value ) {}
-
-				constexpr daw::unique_ptr<ReadProxyImpl> clone( ) const final;
-
-				constexpr IOOpResult read( std::span<char> sp ) final {
-					return ReadableInput<T>::read( reader, sp );
-				}
-
-				constexpr IOOpResult read( std::span<std::byte> sp ) final {
-					return ReadableInput<T>::read( reader, sp );
-				}
-
-				constexpr IOOpResult get( char &c ) final {
-					return ReadableInput<T>::get( reader, c );
-				}
-
-				constexpr IOOpResult get( std::byte &b ) final {
-					return ReadableInput<T>::get( reader, b );
-				}
-			};
-
-			template<typename T>
-			constexpr daw::unique_ptr<ReadProxyImpl>
-			ReadProxyImplChild<T>::clone( ) const {
-				return daw::make_unique<ReadProxyImplChild<T>>( reader );
-			}
-		} // namespace
-	}   // namespace io_details
-
+		template<typename T>
+		inline constexpr read_proxy_vtable_t read_proxy_vtable = {
+		  []( void *r, std::span<char> sp ) -> IOOpResult {
+			  return ReadableInput<T>::read( *static_cast<T *>( r ), sp );
+		  },
+		  []( void *r, std::span<std::byte> sp ) -> IOOpResult {
+			  return ReadableInput<T>::read( *static_cast<T *>( r ), sp );
+		  },
+		  []( void *r, char &c ) -> IOOpResult {
+			  return ReadableInput<T>::get( *static_cast<T *>( r ), c );
+		  },
+		  []( void *r, std::byte &b ) -> IOOpResult {
+			  return ReadableInput<T>::get( *static_cast<T *>( r ), b );
+		  },
+		  []( void *r, std::size_t n ) -> daw::string_view {
+			  return io_details::borrow( *static_cast<T *>( r ), n );
+		  },
+		  has_borrow_v<T> };
+	} // namespace io_details
+
+	/// @brief A type erased, non-owning, reference to a Readable.  It does not
+	/// allocate and is trivially copyable.  The Readable must outlive it
 	class ReadProxy {
-		daw::unique_ptr<io_details::ReadProxyImpl> reader;
+		io_details::read_proxy_vtable_t const *m_vtable = nullptr;
+		void *m_readable = nullptr;
 
 	public:
 		template<typename T>
-		explicit constexpr ReadProxy( T &readable_value )
-		  : reader( daw::make_unique<io_details::ReadProxyImplChild<T>>(
-		      readable_value ) ) {}
-
-		constexpr ReadProxy( ReadProxy const &other )
-		  : reader( other.reader ? other.reader->clone( ) : nullptr ) {}
-
-		constexpr ReadProxy &operator=( ReadProxy const &rhs ) {
-			if( not rhs.reader ) {
-				reader.reset( );
-			} else {
-				reader = rhs.reader->clone( );
-			}
-			return *this;
-		}
+		explicit constexpr ReadProxy( T &readable_value ) noexcept
+		  : m_vtable( std::addressof( io_details::read_proxy_vtable<T> ) )
+		  , m_readable( std::addressof( readable_value ) ) {}
 
-		constexpr ReadProxy( ReadProxy && ) noexcept = default;
-		constexpr ReadProxy &operator=( ReadProxy && ) noexcept = default;
 		constexpr ReadProxy( ) = default;
 
 		constexpr IOOpResult read( std::span<char> sp ) {
-			assert( reader );
-			return reader->read( sp );
+			assert( m_vtable );
+			return m_vtable->read_chars( m_readable, sp );
 		}
 
 		constexpr IOOpResult read( std::span<std::byte> sp ) {
-			assert( reader );
-			return reader->read( sp );
+			assert( m_vtable );
+			return m_vtable->read_bytes( m_readable, sp );
 		}
 
 		constexpr IOOpResult get( char &c ) {
-			assert( reader );
-			return reader->get( c );
+			assert( m_vtable );
+			return m_vtable->get_char( m_readable, c );
 		}
 
 		constexpr IOOpResult get( std::byte &b ) {
-			assert( reader );
-			return reader->get( b );
+			assert( m_vtable );
+			return m_vtable->get_byte( m_readable, b );
+		}
+
+		/// @return Whether the Readable's data is in memory and borrow( n ) can
+		/// return it without copying
+		[[nodiscard]] constexpr bool can_borrow( ) const {
+			assert( m_vtable );
+			return m_vtable->can_borrow;
+		}
+
+		/// @brief Advance by up to n bytes and return a view of them without
+		/// copying.  Empty when can_borrow( ) is false
+		[[nodiscard]] constexpr daw::string_view borrow( std::size_t n ) {
+			assert( m_vtable );
+			return m_vtable->borrow( m_readable, n );
 		}
 	};
 
@@ -13,6 +13,7 @@
 #include <daw/daw_algorithm.h>
 #include <daw/daw_string_view.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <optional>
 #include <span>
@@ -53,5 +54,12 @@ namespace daw::io {
 			b = static_cast<Byte>( result );
 			return { sp.empty( ) ? IOOpStatus::Eof : IOOpStatus::Ok, 1 };
 		}
+
+		static daw::string_view borrow( value_type &sp, std::size_t n ) {
+			auto const result = sp.first( std::min( n, sp.size( ) ) );
+			sp = sp.subspan( result.size( ) );
+			return daw::string_view(
+			  reinterpret_cast<char const *>( result.data( ) ), result.size( ) );
+		}
 	};
 } // namespace daw::io
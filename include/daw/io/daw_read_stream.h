@@ -0,0 +1,212 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw/io/daw_read_proxy.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace daw::io {
+	/// @brief A std::streambuf reading from a ReadProxy.  When the Readable
+	/// can borrow, e.g. daw::string_view, std::span or mmap_reader, the get
+	/// area is its memory and nothing is copied.  Otherwise blocks are read
+	/// into an owned buffer.  Data is read ahead of the stream's position, so
+	/// the Readable should not be read from directly while the
+	/// read_streambuf is in use
+	class read_streambuf : public std::basic_streambuf<char> {
+		ReadProxy m_reader;
+		std::unique_ptr<char[]> m_buffer;
+		std::size_t m_block_size;
+		IOOpStatus m_status = IOOpStatus::Ok;
+
+		template<typename ReadableType>
+		static constexpr bool is_readable_type =
+		  not std::is_same_v<read_streambuf, ReadableType> and
+		  not std::is_same_v<ReadProxy, ReadableType> and
+		  not std::is_const_v<ReadableType>;
+
+		void set_get_area( char const *first, std::size_t size ) {
+			// The get area is never written to, as pbackfail is not overridden,
+			// so borrowed read only memory is safe here
+			auto *p = const_cast<char *>( first );
+			setg( p, p, p + size );
+		}
+
+		/// @brief Read directly into the caller's memory
+		/// @return The number of bytes read
+		std::size_t read_into( std::span<char> buffer ) {
+			auto const ret = m_reader.read( buffer );
+			m_status = ret.status;
+			return ret.count;
+		}
+
+		/// @return Whether more data was made available in the get area
+		bool refill( ) {
+			if( m_status != IOOpStatus::Ok ) {
+				return false;
+			}
+			if( m_reader.can_borrow( ) ) {
+				auto const sv =
+				  m_reader.borrow( std::numeric_limits<std::size_t>::max( ) );
+				// A borrow returns all that remains
+				m_status = IOOpStatus::Eof;
+				set_get_area( sv.data( ), sv.size( ) );
+				return not sv.empty( );
+			}
+			if( not m_buffer ) {
+				m_buffer = std::make_unique_for_overwrite<char[]>( m_block_size );
+			}
+			auto const count =
+			  read_into( std::span<char>( m_buffer.get( ), m_block_size ) );
+			set_get_area( m_buffer.get( ), count );
+			return count > 0;
+		}
+
+	public:
+		static constexpr std::size_t default_block_size = 4096U;
+
+		/// @param block_size The size of the buffer used when the Readable
+		/// cannot borrow
+		template<typename ReadableType,
+		         std::enable_if_t<is_readable_type<ReadableType>, std::nullptr_t> =
+		           nullptr>
+		explicit inline read_streambuf(
+		  ReadableType &reader, std::size_t block_size = default_block_size )
+		  : m_reader( reader )
+		  , m_block_size( std::max( block_size, std::size_t{ 1 } ) ) {}
+
+		explicit inline read_streambuf(
+		  ReadProxy const &reader, std::size_t block_size = default_block_size )
+		  : m_reader( reader )
+		  , m_block_size( std::max( block_size, std::size_t{ 1 } ) ) {}
+
+		explicit inline read_streambuf(
+		  ReadProxy &&reader, std::size_t block_size = default_block_size )
+		  : m_reader( std::move( reader ) )
+		  , m_block_size( std::max( block_size, std::size_t{ 1 } ) ) {}
+
+		read_streambuf( read_streambuf const & ) = delete;
+		read_streambuf &operator=( read_streambuf const & ) = delete;
+
+		inline int_type underflow( ) override {
+			if( gptr( ) == egptr( ) and not refill( ) ) {
+				return traits_type::eof( );
+			}
+			return traits_type::to_int_type( *gptr( ) );
+		}
+
+		inline std::streamsize xsgetn( char_type *str,
+		                               std::streamsize n ) override {
+			if( n <= 0 ) {
+				return 0;
+			}
+			auto const sz = static_cast<std::size_t>( n );
+			std::size_t done = 0;
+			while( done < sz ) {
+				if( gptr( ) == egptr( ) ) {
+					auto const rest = sz - done;
+					if( rest >= m_block_size and m_status == IOOpStatus::Ok and
+					    not m_reader.can_borrow( ) ) {
+						// Large reads bypass the buffer
+						auto const count = read_into( std::span<char>( str + done, rest ) );
+						if( count == 0 ) {
+							break;
+						}
+						done += count;
+						continue;
+					}
+					if( not refill( ) ) {
+						break;
+					}
+				}
+				auto const available = static_cast<std::size_t>( egptr( ) - gptr( ) );
+				auto const count = std::min( available, sz - done );
+				std::memcpy( str + done, gptr( ), count );
+				setg( eback( ), gptr( ) + count, egptr( ) );
+				done += count;
+			}
+			return static_cast<std::streamsize>( done );
+		}
+
+		/// @return -1 once the Readable has no more data, otherwise 0 as the
+		/// amount available without blocking is not known
+		inline std::streamsize showmanyc( ) override {
+			return m_status == IOOpStatus::Ok ? 0 : -1;
+		}
+
+		/// @return Ok while the Readable may have more data, Eof after it was
+		/// exhausted or Error when a read failed
+		[[nodiscard]] IOOpStatus status( ) const {
+			return m_status;
+		}
+
+		ReadProxy const &reader( ) const {
+			return m_reader;
+		}
+
+		ReadProxy &reader( ) {
+			return m_reader;
+		}
+	};
+
+	class read_istream : public std::istream {
+		read_streambuf m_stream;
+
+		template<typename ReadableType>
+		static constexpr bool is_readable_type =
+		  not std::is_same_v<read_istream, ReadableType> and
+		  not std::is_same_v<ReadProxy, ReadableType> and
+		  not std::is_const_v<ReadableType>;
+
+	public:
+		template<typename ReadableType,
+		         std::enable_if_t<is_readable_type<ReadableType>, std::nullptr_t> =
+		           nullptr>
+		explicit inline read_istream(
+		  ReadableType &reader,
+		  std::size_t block_size = read_streambuf::default_block_size )
+		  : std::istream( nullptr )
+		  , m_stream( reader, block_size ) {
+			rdbuf( std::addressof( m_stream ) );
+		}
+
+		explicit inline read_istream(
+		  ReadProxy const &reader,
+		  std::size_t block_size = read_streambuf::default_block_size )
+		  : std::istream( nullptr )
+		  , m_stream( reader, block_size ) {
+			rdbuf( std::addressof( m_stream ) );
+		}
+
+		explicit inline read_istream(
+		  ReadProxy &&reader,
+		  std::size_t block_size = read_streambuf::default_block_size )
+		  : std::istream( nullptr )
+		  , m_stream( std::move( reader ), block_size ) {
+			rdbuf( std::addressof( m_stream ) );
+		}
+
+		ReadProxy const &reader( ) const {
+			return m_stream.reader( );
+		}
+
+		ReadProxy &reader( ) {
+			return m_stream.reader( );
+		}
+	};
+} // namespace daw::io
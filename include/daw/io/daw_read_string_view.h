@@ -13,6 +13,7 @@
 #include <daw/daw_algorithm.h>
 #include <daw/daw_string_view.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <optional>
 #include <span>
@@ -49,6 +50,12 @@ namespace daw::io {
 			b = static_cast<Byte>( result );
 			return { sv.empty( ) ? IOOpStatus::Eof : IOOpStatus::Ok, 1 };
 		}
+
+		static daw::string_view borrow( value_type &sv, std::size_t n ) {
+			auto const result = sv.pop_front( n );
+			return daw::string_view(
+			  reinterpret_cast<char const *>( result.data( ) ), result.size( ) );
+		}
 	};
 
 	template<typename CharT, typename Traits>
@@ -83,5 +90,12 @@ namespace daw::io {
 			b = static_cast<Byte>( result );
 			return { sv.empty( ) ? IOOpStatus::Eof : IOOpStatus::Ok, 1 };
 		}
+
+		static daw::string_view borrow( value_type &sv, std::size_t n ) {
+			auto const result = sv.substr( 0, std::min( n, sv.size( ) ) );
+			sv.remove_prefix( result.size( ) );
+			return daw::string_view(
+			  reinterpret_cast<char const *>( result.data( ) ), result.size( ) );
+		}
 	};
 } // namespace daw::io
@@ -0,0 +1,272 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_fd_wrap.h"
+#include "daw_io_uring.h"
+#include "daw_read_base.h"
+#include "daw_read_fd.h"
+
+#include <daw/daw_algorithm.h>
+#include <daw/daw_traits.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <unistd.h>
+
+namespace daw::io {
+	/// @brief Read from a file descriptor through io_uring, keeping up to
+	/// queue_depth reads ahead of the caller in flight.  A regular file is read
+	/// at increasing offsets, all in flight at once.  Pipes and sockets have
+	/// one read in flight at a time.  When io_uring is unavailable reads go
+	/// directly to the fd as with fd_wrap_t.  On destruction the file position
+	/// of a regular file is set to after the bytes returned, data read ahead
+	/// from a pipe or socket is lost.  The fd remains owned by the caller and
+	/// must outlive the uring_reader
+	class uring_reader {
+		struct buffer_state {
+			std::int64_t offset = -1;
+			int result = 0;
+			bool in_flight = false;
+			bool done = false;
+		};
+
+		int m_fd;
+		io_details::uring_buffers m_memory;
+		std::vector<buffer_state> m_buffers;
+		// After m_memory so that the ring, and its requests, go first
+		io_details::uring m_ring;
+		// The file offset of the next read submitted and of the next byte
+		// returned to the caller, or -1 when reading at the file position
+		std::int64_t m_next_offset = -1;
+		std::int64_t m_position = -1;
+		std::size_t m_max_in_flight = 1;
+		std::size_t m_in_flight = 0;
+		// The buffer being consumed and the next one to submit, in file order
+		std::size_t m_current = 0;
+		std::size_t m_next_submit = 0;
+		std::size_t m_read_pos = 0;
+		bool m_eof = false;
+		IOOpStatus m_status = IOOpStatus::Ok;
+
+		[[nodiscard]] bool is_seekable( ) const {
+			return m_next_offset >= 0;
+		}
+
+		void queue_read( std::size_t idx ) {
+			m_ring.queue_rw( static_cast<std::uint8_t>( m_memory.is_fixed( )
+			                                              ? IORING_OP_READ_FIXED
+			                                              : IORING_OP_READ ),
+			                 m_fd, m_memory.data( idx ), m_memory.buffer_size( ),
+			                 m_buffers[idx].offset, m_memory.fixed_index( idx ), idx );
+		}
+
+		/// @brief Submit reads into the free buffers following those queued
+		[[nodiscard]] bool fill_queue( ) {
+			bool queued = false;
+			while( not m_eof and m_in_flight < m_max_in_flight ) {
+				buffer_state &b = m_buffers[m_next_submit];
+				if( b.in_flight or b.done ) {
+					break;
+				}
+				b.offset = m_next_offset;
+				if( is_seekable( ) ) {
+					m_next_offset += static_cast<std::int64_t>( m_memory.buffer_size( ) );
+				}
+				b.in_flight = true;
+				++m_in_flight;
+				queue_read( m_next_submit );
+				queued = true;
+				m_next_submit = ( m_next_submit + 1 ) % m_buffers.size( );
+			}
+			if( queued and not m_ring.submit( ) ) {
+				m_status = IOOpStatus::Error;
+				return false;
+			}
+			return true;
+		}
+
+		void complete( io_details::uring_completion const &cqe ) {
+			auto const idx = static_cast<std::size_t>( cqe.user_data );
+			buffer_state &b = m_buffers[idx];
+			if( cqe.res == -EINTR or cqe.res == -EAGAIN ) {
+				queue_read( idx );
+				return;
+			}
+			b.result = cqe.res;
+			b.in_flight = false;
+			b.done = true;
+			--m_in_flight;
+			if( cqe.res == 0 ) {
+				m_eof = true;
+			}
+		}
+
+		/// @brief Wait for at least one completion and process all available
+		[[nodiscard]] bool wait_one( ) {
+			if( not m_ring.submit( 1 ) ) {
+				m_status = IOOpStatus::Error;
+				return false;
+			}
+			while( auto const cqe = m_ring.pop_completion( ) ) {
+				complete( *cqe );
+			}
+			return true;
+		}
+
+		/// @brief Wait for every read in flight
+		void drain( ) {
+			while( m_in_flight > 0 ) {
+				if( not wait_one( ) ) {
+					return;
+				}
+			}
+		}
+
+		/// @brief A short read means the reads queued after it used the wrong
+		/// offsets.  Discard them and read again from where it ended
+		void resync( std::int64_t offset ) {
+			drain( );
+			for( buffer_state &b : m_buffers ) {
+				b = buffer_state{ };
+			}
+			m_eof = false;
+			m_next_offset = offset;
+			m_next_submit = m_current;
+		}
+
+		/// @brief Mark the current buffer as consumed and move to the next
+		void next_buffer( ) {
+			buffer_state &b = m_buffers[m_current];
+			bool const is_short =
+			  b.result > 0 and
+			  static_cast<std::size_t>( b.result ) < m_memory.buffer_size( );
+			auto const end_offset = b.offset + b.result;
+			b = buffer_state{ };
+			m_read_pos = 0;
+			m_current = ( m_current + 1 ) % m_buffers.size( );
+			if( is_short and is_seekable( ) ) {
+				resync( end_offset );
+			}
+		}
+
+	public:
+		explicit uring_reader( fd_wrap_t fd, uring_options opts = uring_options{ } )
+		  : m_fd( fd.value )
+		  , m_memory( opts )
+		  , m_buffers( m_memory.count( ) )
+		  , m_ring( static_cast<unsigned>( m_memory.count( ) ) ) {
+			if( not m_ring.is_open( ) ) {
+				return;
+			}
+			if( opts.register_buffers ) {
+				(void)m_memory.register_with( m_ring );
+			}
+			auto const pos = ::lseek( m_fd, 0, SEEK_CUR );
+			if( pos >= 0 ) {
+				m_next_offset = static_cast<std::int64_t>( pos );
+				m_position = m_next_offset;
+				m_max_in_flight = m_buffers.size( );
+			}
+		}
+
+		uring_reader( uring_reader const & ) = delete;
+		uring_reader &operator=( uring_reader const & ) = delete;
+
+		~uring_reader( ) {
+			if( not m_ring.is_open( ) ) {
+				return;
+			}
+			drain( );
+			if( m_position >= 0 ) {
+				::lseek( m_fd, static_cast<::off_t>( m_position ), SEEK_SET );
+			}
+		}
+
+		/// @return true when reads go through io_uring, false when they use the
+		/// fd directly
+		[[nodiscard]] bool is_async( ) const {
+			return m_ring.is_open( );
+		}
+
+		/// @brief Copy up to buff.size( ) bytes that have been read ahead.  Only
+		/// waits for a read when none are ready
+		/// @return Ok with the count, or Eof with 0 once the end was reached
+		template<typename Byte>
+		IOOpResult read( std::span<Byte> buff ) {
+			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
+			if( not m_ring.is_open( ) ) {
+				return ReadableInput<fd_wrap_t>::read( fd_wrap_t( m_fd ), buff );
+			}
+			if( m_status != IOOpStatus::Ok or not fill_queue( ) ) {
+				return { IOOpStatus::Error, 0 };
+			}
+			std::size_t copied = 0;
+			while( copied < buff.size( ) ) {
+				buffer_state const &b = m_buffers[m_current];
+				if( not b.done ) {
+					if( not b.in_flight or copied > 0 ) {
+						break;
+					}
+					if( not wait_one( ) ) {
+						return { IOOpStatus::Error, copied };
+					}
+					continue;
+				}
+				if( b.result < 0 ) {
+					m_status = IOOpStatus::Error;
+					return { IOOpStatus::Error, copied };
+				}
+				auto const n = std::min( buff.size( ) - copied,
+				                         static_cast<std::size_t>( b.result ) - m_read_pos );
+				(void)daw::algorithm::convert_copy_n<Byte>(
+				  m_memory.data( m_current ) + m_read_pos, buff.data( ) + copied, n );
+				m_read_pos += n;
+				copied += n;
+				if( m_position >= 0 ) {
+					m_position += static_cast<std::int64_t>( n );
+				}
+				if( m_read_pos == static_cast<std::size_t>( b.result ) ) {
+					next_buffer( );
+					if( not fill_queue( ) ) {
+						return { IOOpStatus::Error, copied };
+					}
+				}
+			}
+			if( copied == 0 and buff.size( ) > 0 ) {
+				return { IOOpStatus::Eof, 0 };
+			}
+			return { IOOpStatus::Ok, copied };
+		}
+
+		template<typename Byte>
+		IOOpResult get( Byte &b ) {
+			return read( std::span<Byte>( std::addressof( b ), 1 ) );
+		}
+	};
+
+	template<>
+	struct ReadableInput<uring_reader> {
+		template<typename Byte>
+		static IOOpResult read( uring_reader &ur, std::span<Byte> buff ) {
+			return ur.read( buff );
+		}
+
+		template<typename Byte>
+		static IOOpResult get( uring_reader &ur, Byte &b ) {
+			return ur.get( b );
+		}
+	};
+} // namespace daw::io
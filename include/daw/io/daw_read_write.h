@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "daw_delimited_reader.h"
 #include "daw_peekable_read_proxy.h"
 #include "daw_read_proxy.h"
 #include "daw_readable_input.h"
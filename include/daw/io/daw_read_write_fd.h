@@ -9,4 +9,11 @@
 #pragma once
 
 #include "daw_read_fd.h"
+#include "daw_read_mmap.h"
 #include "daw_write_fd.h"
+#include "daw_write_mmap.h"
+#if __has_include( <linux/io_uring.h> )
+#include "daw_read_uring.h"
+#include "daw_write_uring.h"
+#endif
+#include "util/daw_io_algorithms_fd.h"
@@ -9,10 +9,17 @@
 #pragma once
 
 #include "daw_read_write.h"
+#include "type_writers/daw_float_writer.h"
+#include "type_writers/daw_format_spec.h"
 #include "type_writers/daw_integer_writer.h"
 
 #include <daw/cpp_17.h>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
 #include <type_traits>
 
 namespace daw::io::type_writer {
@@ -26,10 +33,67 @@ namespace daw::io::type_writer {
 	inline constexpr bool has_type_writer_v =
 	  daw::is_detected_v<impl::has_type_writer_test, T>;
 
+	namespace impl {
+		template<typename T>
+		using has_type_writer_size_test =
+		  decltype( type_writer_size( std::declval<T const &>( ) ) );
+	}
+
+	/// A type_writer can provide a type_writer_size( T const & ) returning the
+	/// characters it writes, or an upper bound of them
+	template<typename T>
+	inline constexpr bool has_type_writer_size_v =
+	  daw::is_detected_v<impl::has_type_writer_size_test, T>;
+
+	namespace impl {
+		template<typename T>
+		inline constexpr bool is_char_arg_v =
+		  std::is_constructible_v<char, T> and sizeof( T ) == 1;
+
+		template<typename T>
+		inline constexpr bool is_sizable_v =
+		  is_char_arg_v<T> or
+		  std::is_constructible_v<daw::string_view, T const &> or
+		  has_type_writer_size_v<T>;
+
+		template<typename... Ts>
+		inline constexpr bool can_size_v =
+		  ( is_sizable_v<std::remove_cvref_t<Ts>> and ... );
+
+		/// @brief The characters write_all writes for item
+		template<typename T>
+		[[nodiscard]] constexpr std::size_t arg_size( T const &item ) {
+			if constexpr( is_char_arg_v<T> ) {
+				(void)item;
+				return 1;
+			} else if constexpr( std::is_constructible_v<daw::string_view,
+			                                             T const &> ) {
+				return daw::string_view( item ).size( );
+			} else {
+				return type_writer_size( item );
+			}
+		}
+	} // namespace impl
+
+	/// @brief The number of characters write_all writes for args.  It is exact
+	/// for strings, characters and integers and an upper bound for floats
+	template<typename... Ts>
+	[[nodiscard]] constexpr std::size_t formatted_size( Ts const &...args ) {
+		static_assert( impl::can_size_v<Ts...>,
+		               "Unsupported type.  Maybe a type_writer_size is needed" );
+		return ( std::size_t{ 0 } + ... + impl::arg_size( args ) );
+	}
+
 	/// Attempt to use the type_writer interface when args isn't a string like
-	/// parameter.
+	/// parameter.  Growable sinks reserve formatted_size( args... ) first, so
+	/// they grow at most once
 	template<typename Writer, typename... Ts>
 	[[nodiscard]] IOOpResult write_all( Writer &writer, Ts &&...args ) {
+		if constexpr( sizeof...( Ts ) > 1 and impl::can_size_v<Ts...> ) {
+			daw::io::reserve_for( writer, [&] {
+				return formatted_size( args... );
+			} );
+		}
 		auto result = IOOpResult{ };
 		auto write_item = [&]( auto &&item ) {
 			using item_t = DAW_TYPEOF( item );
@@ -59,9 +123,29 @@ namespace daw::io::type_writer {
 	struct incorrect_param_count_exception {
 		explicit incorrect_param_count_exception( ) = default;
 	};
+
+	/// @brief The literal text of a format string before an argument, or after
+	/// the last one
+	struct format_segment {
+		daw::string_view text;
+		/// text has "{{" that are written as "{"
+		bool has_escapes = false;
+	};
+
+	/// @brief A format string with a "{}" placeholder for each of Ts.  It is
+	/// split into literal segments when it is constructed, at compile time, so
+	/// print only writes them and the arguments.  "{{" is a literal '{'.  A
+	/// placeholder may have a spec, e.g. "{:>10}", "{:08x}" or "{:.3f}", see
+	/// format_spec
 	template<typename... Ts>
 	struct format_str {
 		daw::string_view value;
+		std::array<format_segment, sizeof...( Ts ) + 1> segments{ };
+		std::array<format_spec, sizeof...( Ts )> specs{ };
+		/// The characters written for the segments
+		std::size_t literal_size = 0;
+		bool has_escapes = false;
+		bool has_specs = false;
 
 		template<typename T,
 		         std::enable_if_t<std::is_constructible_v<daw::string_view, T>,
@@ -71,79 +155,280 @@ namespace daw::io::type_writer {
 			check( );
 		}
 
+		/// @brief Split value into segments and parse the placeholder specs
+		/// @throws incorrect_param_count_exception, as a compile error, when the
+		/// number of placeholders is not sizeof...( Ts )
+		/// @throws invalid_format_spec_exception, as a compile error, when a spec
+		/// is malformed or does not apply to its argument's type
 		consteval void check( ) {
-			auto str = daw::string_view( value );
 			constexpr std::size_t size_needed = sizeof...( Ts );
+			constexpr std::array<impl::arg_kind, size_needed> kinds = {
+			  impl::arg_kind_of<Ts>( )... };
+			char const *const last = value.data_end( );
+			char const *segment_first = value.data( );
+			bool segment_escapes = false;
 			std::size_t param_count = 0;
-			std::size_t brace_count = 0;
-			while( not str.empty( ) ) {
-				str.remove_prefix_until( '{', nodiscard );
-				if( str.starts_with( '{' ) ) {
-					str.remove_prefix( );
-					str.trim_prefix( );
-					++brace_count;
-					if( brace_count % 2 == 1 and str.starts_with( '}' ) ) {
-						str.remove_prefix( );
-						brace_count = 0;
-						++param_count;
+			char const *ptr = value.data( );
+			while( ptr != last ) {
+				if( *ptr != '{' ) {
+					++ptr;
+					continue;
+				}
+				if( ptr + 1 != last and ptr[1] == '{' ) {
+					segment_escapes = true;
+					--literal_size;
+					ptr += 2;
+					continue;
+				}
+				char const *close = ptr + 1;
+				while( close != last and
+				       ( *close == ' ' or *close == '\t' or *close == '\n' or
+				         *close == '\r' ) ) {
+					++close;
+				}
+				char const *spec_first = close;
+				if( close != last and *close == ':' ) {
+					spec_first = ++close;
+					while( close != last and *close != '}' ) {
+						if( *close == '{' ) {
+							// Nested replacement fields are not supported
+							throw invalid_format_spec_exception{ };
+						}
+						++close;
 					}
+					if( close == last ) {
+						throw invalid_format_spec_exception{ };
+					}
+				}
+				if( close == last or *close != '}' ) {
+					// A lone '{' is literal text
+					++ptr;
+					continue;
+				}
+				if( param_count == size_needed ) {
+					throw incorrect_param_count_exception{ };
 				}
+				specs[param_count] = impl::parse_format_spec(
+				  daw::string_view( spec_first, close ), kinds[param_count] );
+				has_specs = has_specs or not specs[param_count].is_default( );
+				segments[param_count++] = {
+				  daw::string_view( segment_first, ptr ), segment_escapes };
+				literal_size += static_cast<std::size_t>( ptr - segment_first );
+				has_escapes = has_escapes or segment_escapes;
+				ptr = close + 1;
+				segment_first = ptr;
+				segment_escapes = false;
 			}
 			if( param_count != size_needed ) {
 				throw incorrect_param_count_exception{ };
 			}
+			segments[param_count] = { daw::string_view( segment_first, last ),
+			                          segment_escapes };
+			literal_size += static_cast<std::size_t>( last - segment_first );
+			has_escapes = has_escapes or segment_escapes;
 		}
 	};
 
+	namespace impl {
+		template<typename Writer>
+		[[nodiscard]] IOOpResult write_segment( Writer &writer,
+		                                        format_segment const &segment ) {
+			if( not segment.has_escapes ) {
+				if( segment.text.empty( ) ) {
+					return { };
+				}
+				return writer.write( segment.text );
+			}
+			// Write up to and including the first of each "{{"
+			char const *first = segment.text.data( );
+			char const *const last = segment.text.data_end( );
+			char const *ptr = first;
+			auto result = IOOpResult{ };
+			while( ptr != last ) {
+				bool const is_escape =
+				  ptr[0] == '{' and ptr + 1 != last and ptr[1] == '{';
+				if( not is_escape and ptr + 1 != last ) {
+					++ptr;
+					continue;
+				}
+				auto const r = writer.write( daw::string_view( first, ptr + 1 ) );
+				result.status = r.status;
+				result.count += r.count;
+				if( r.status != IOOpStatus::Ok ) {
+					break;
+				}
+				ptr += is_escape ? 2 : 1;
+				first = ptr;
+			}
+			return result;
+		}
+
+		inline constexpr std::size_t cannot_gather =
+		  std::numeric_limits<std::size_t>::max( );
+
+		/// @return The most characters an argument of type T formats to when
+		/// print can format it into a stack buffer, 0 when it is written from its
+		/// own memory or cannot_gather
+		template<typename T>
+		consteval std::size_t gather_size( ) {
+			if constexpr( std::is_constructible_v<daw::string_view, T const &> ) {
+				return 0;
+			} else if constexpr( daw::is_integral_v<T> ) {
+				return max_formatted_digits<T>;
+			} else if constexpr( is_float_writable_v<T> ) {
+				return max_shortest_chars<T>;
+			} else {
+				return cannot_gather;
+			}
+		}
+
+		template<typename W>
+		using has_write_vectored_member_test =
+		  decltype( std::declval<W &>( ).write_vectored(
+		    std::declval<std::span<daw::string_view const>>( ) ) );
+
+		/// Gathering pays off when each write is costly and the sink writes a
+		/// list of buffers natively, e.g. with writev.  Sinks that can prepare
+		/// are in memory and are faster written piece by piece.  A WriteProxy
+		/// may be either, so it gathers to avoid a system call per piece
+		template<typename WriterT>
+		inline constexpr bool prefers_gather_v =
+		  daw::is_detected_v<has_write_vectored_member_test, WriterT> and
+		  not daw::is_detected_v<io_details::has_prepare_member_test, WriterT>;
+
+		template<typename T>
+		inline constexpr bool prefers_gather_v<daw::io::Writer<T>> =
+		  has_write_vectored_v<T> and not has_prepare_v<T>;
+
+		template<>
+		inline constexpr bool prefers_gather_v<daw::io::WriteProxy> = true;
+
+		template<>
+		inline constexpr bool prefers_gather_v<daw::io::Writer<WriteProxy>> =
+		  true;
+
+		template<typename... Ts>
+		inline constexpr bool can_gather_v =
+		  ( ( gather_size<std::remove_cvref_t<Ts>>( ) != cannot_gather ) and
+		    ... );
+
+		/// @brief Format the arguments into a stack buffer and write them and
+		/// the segments with a single write_vectored
+		template<typename Writer, std::size_t N, typename... Ts>
+		[[nodiscard]] IOOpResult
+		print_gathered( Writer &writer,
+		                std::array<format_segment, N> const &segments,
+		                Ts const &...args ) {
+			constexpr std::size_t buffer_size =
+			  ( gather_size<std::remove_cvref_t<Ts>>( ) + ... + 1U );
+			char buff[buffer_size];
+			auto rest = std::span<char>( buff );
+			auto rest_writer = daw::io::Writer( rest );
+			std::array<daw::string_view, N * 2U> views{ };
+			std::size_t view_count = 0;
+			auto const add_view = [&]( daw::string_view sv ) {
+				if( not sv.empty( ) ) {
+					views[view_count++] = sv;
+				}
+			};
+			std::size_t n = 0;
+			auto const add_arg = [&]( auto const &arg ) {
+				add_view( segments[n++].text );
+				using arg_t = std::remove_cvref_t<decltype( arg )>;
+				if constexpr( gather_size<arg_t>( ) == 0 ) {
+					add_view( daw::string_view( arg ) );
+				} else {
+					char const *first = rest.data( );
+					(void)write_all( rest_writer, arg );
+					add_view( daw::string_view( first, rest.data( ) ) );
+				}
+			};
+			( add_arg( args ), ... );
+			(void)add_arg;
+			add_view( segments[n].text );
+			return writer.write_vectored(
+			  std::span<daw::string_view const>( views.data( ), view_count ) );
+		}
+	} // namespace impl
+
+	namespace impl {
+		/// @brief The characters print writes, see formatted_size
+		template<typename... Ts, typename... Args>
+		[[nodiscard]] constexpr std::size_t
+		print_size( format_str<Ts...> const &format_string,
+		            Args const &...args ) {
+			std::size_t result = format_string.literal_size;
+			std::size_t n = 0;
+			auto const add_arg = [&]( auto const &arg ) {
+				auto const &spec = format_string.specs[n++];
+				using arg_t = std::remove_cvref_t<decltype( arg )>;
+				if constexpr( arg_kind_of<arg_t>( ) != arg_kind::other ) {
+					if( not spec.is_default( ) ) {
+						result += field_size( spec, arg );
+						return;
+					}
+				}
+				result += arg_size( arg );
+			};
+			( add_arg( args ), ... );
+			(void)add_arg;
+			return result;
+		}
+	} // namespace impl
+
+	/// @brief Write format_string with each "{}" replaced by the next of args.
+	/// When the arguments are strings, characters or numbers, there are no
+	/// specs and the sink benefits, everything is written with one
+	/// write_vectored, otherwise piece by piece.  A field with a spec is padded
+	/// in place and written at once.  Growable sinks reserve the total first,
+	/// so they grow at most once
 	template<typename Writer, typename... Ts>
 	IOOpResult print( Writer &writer,
 	                  format_str<std::type_identity_t<Ts>...> format_string,
 	                  Ts &&...args ) {
-		auto fmt_str = format_string.value;
-		std::size_t brace_count = 0;
-		auto last_result = IOOpResult{ };
-		auto process = [&]( auto &&arg ) -> IOOpResult {
-			if( last_result.status != IOOpStatus::Ok ) {
-				return { last_result.status, 0 };
+		auto const &segments = format_string.segments;
+		// Before gathering too, as a WriteProxy gathers for whatever it wraps,
+		// including sinks that write the views one at a time
+		if constexpr( impl::can_size_v<Ts...> ) {
+			daw::io::reserve_for( writer, [&] {
+				return impl::print_size( format_string, args... );
+			} );
+		}
+		if constexpr( impl::prefers_gather_v<Writer> and
+		              impl::can_gather_v<Ts...> ) {
+			if( not format_string.has_escapes and not format_string.has_specs ) {
+				return impl::print_gathered( writer, segments, args... );
 			}
-			char const *first = fmt_str.data( );
-			while( not fmt_str.empty( ) ) {
-				auto part = fmt_str.pop_front_until( '{' );
-				fmt_str.trim_prefix( );
-				++brace_count;
-				if( brace_count % 2 == 1 and fmt_str.starts_with( '}' ) ) {
-					brace_count = 0;
-					fmt_str.remove_prefix( );
-					last_result =
-					  write_all( writer, daw::string_view( first, part.data_end( ) ),
-					             DAW_FWD( arg ) );
-					if( not fmt_str.empty( ) ) {
-						first = fmt_str.data( );
-					}
-					return last_result;
-				} else if( brace_count > 0 and brace_count % 2 == 0 ) {
-					brace_count = 0;
-					last_result = writer.write( daw::string_view( first, part.data_end( ) ) );
-					if( not fmt_str.empty( ) ) {
-						first = fmt_str.data( );
-					}
+		}
+		auto result = IOOpResult{ };
+		auto const accumulate = [&]( IOOpResult const &r ) {
+			result.status = r.status;
+			result.count += r.count;
+		};
+		std::size_t n = 0;
+		auto const process = [&]( auto const &arg ) {
+			if( result.status != IOOpStatus::Ok ) {
+				return;
+			}
+			auto const &spec = format_string.specs[n];
+			accumulate( impl::write_segment( writer, segments[n++] ) );
+			if( result.status != IOOpStatus::Ok ) {
+				return;
+			}
+			using arg_t = std::remove_cvref_t<decltype( arg )>;
+			if constexpr( impl::arg_kind_of<arg_t>( ) != impl::arg_kind::other ) {
+				if( not spec.is_default( ) ) {
+					accumulate( impl::write_formatted( writer, spec, arg ) );
+					return;
 				}
 			}
-			// This should never be reached as we know there are the same number of {}
-			// as args
-			std::abort( );
+			accumulate( write_all( writer, arg ) );
 		};
-		IOOpResult results[] = { process( DAW_FWD( args ) )... };
-		if( last_result.status == IOOpStatus::Ok ) {
-			auto tmp = writer.write( fmt_str );
-			last_result.status = tmp.status;
-			last_result.count += tmp.count;
+		( process( args ), ... );
+		(void)process;
+		if( result.status == IOOpStatus::Ok ) {
+			accumulate( impl::write_segment( writer, segments[n] ) );
 		}
-		auto total_size =
-		  std::accumulate( std::data( results ), daw::data_end( results ),
-		                   std::size_t{ 0 }, []( std::size_t t, auto const &r ) {
-			                   return t + r.count;
-		                   } );
-		return { last_result.status, total_size };
+		return result;
 	}
-} // namespace daw::io::type_writer
\ No newline at end of file
+} // namespace daw::io::type_writer
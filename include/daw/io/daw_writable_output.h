@@ -9,6 +9,7 @@
 #pragma once
 
 #include "daw_write_base.h"
+#include "daw_write_buffered.h"
 #include "daw_write_cfile.h"
 #include "daw_write_ostream.h"
 #include "daw_write_pointer.h"
@@ -10,16 +10,40 @@
 
 #include "daw_io_base.h"
 
+#include <daw/cpp_17.h>
 #include <daw/daw_always_false.h>
 #include <daw/daw_string_view.h>
 
+#include <cassert>
 #include <cstddef>
 #include <initializer_list>
 #include <span>
+#include <utility>
 
 namespace daw::io {
 	// Base trait for WritableOutput.  Specializations must have the methods
-	// declared here
+	// declared here.
+	//
+	// Optionally, a specialization can provide
+	//   static IOOpResult write_vectored( T &, std::span<daw::string_view const> )
+	//   static IOOpResult write_vectored( T &,
+	//                                     std::span<std::span<std::byte const> const> )
+	// to write a runtime sized list of buffers natively, e.g. with writev
+	//
+	// and
+	//   static std::span<char> prepare( T &, std::size_t n )
+	//   static IOOpResult commit( T &, std::span<char> prepared,
+	//                             std::size_t count )
+	// so that formatters can write directly into the output.  prepare returns
+	// at least n writable bytes at the current position, or an empty span when
+	// it cannot.  commit makes the first count bytes of the span returned by
+	// the previous prepare part of the output.  Every non-empty prepare must be
+	// followed by a commit, before any other operation on the value
+	//
+	// and
+	//   static void reserve( T &, std::size_t n )
+	// for growable outputs, so that n more bytes can be written without
+	// reallocating.  It is a hint and does not change the output
 	template<typename T>
 	struct WritableOutput {
 		[[noreturn]] static IOOpResult write( T &, daw::string_view ) {
@@ -54,4 +78,164 @@ namespace daw::io {
 			               "WritableOutput not specialized for type" );
 		}
 	};
+
+	namespace io_details {
+		template<typename T, typename Buffer>
+		using has_write_vectored_test =
+		  decltype( WritableOutput<T>::write_vectored(
+		    std::declval<T &>( ), std::declval<std::span<Buffer const>>( ) ) );
+	} // namespace io_details
+
+	template<typename T, typename Buffer = daw::string_view>
+	inline constexpr bool has_write_vectored_v =
+	  daw::is_detected_v<io_details::has_write_vectored_test, T, Buffer>;
+
+	namespace io_details {
+		template<typename T>
+		using has_prepare_test = decltype( WritableOutput<T>::prepare(
+		  std::declval<T &>( ), std::declval<std::size_t>( ) ) );
+
+		template<typename W>
+		using has_prepare_member_test =
+		  decltype( std::declval<W &>( ).prepare( std::declval<std::size_t>( ) ) );
+	} // namespace io_details
+
+	template<typename T>
+	inline constexpr bool has_prepare_v =
+	  daw::is_detected_v<io_details::has_prepare_test, T>;
+
+	namespace io_details {
+		template<typename T>
+		using has_reserve_test = decltype( WritableOutput<T>::reserve(
+		  std::declval<T &>( ), std::declval<std::size_t>( ) ) );
+
+		template<typename W>
+		using has_can_reserve_member_test =
+		  decltype( std::declval<W &>( ).can_reserve( ) );
+	} // namespace io_details
+
+	template<typename T>
+	inline constexpr bool has_reserve_v =
+	  daw::is_detected_v<io_details::has_reserve_test, T>;
+
+	namespace io_details {
+		/// @brief Make room for n more bytes of output, when writable_value
+		/// supports it
+		template<typename T>
+		constexpr void reserve( T &writable_value, std::size_t n ) {
+			if constexpr( has_reserve_v<T> ) {
+				WritableOutput<T>::reserve( writable_value, n );
+			} else {
+				(void)writable_value;
+				(void)n;
+			}
+		}
+
+		/// @brief Acquire n bytes of the output of writable_value to write into
+		/// directly
+		/// @return The memory, or an empty span when unsupported or unavailable
+		template<typename T>
+		[[nodiscard]] constexpr std::span<char> prepare( T &writable_value,
+		                                                 std::size_t n ) {
+			if constexpr( has_prepare_v<T> ) {
+				return WritableOutput<T>::prepare( writable_value, n );
+			} else {
+				(void)writable_value;
+				(void)n;
+				return { };
+			}
+		}
+
+		/// @brief Complete a previous prepare, keeping count bytes of it
+		template<typename T>
+		constexpr IOOpResult commit( T &writable_value, std::span<char> prepared,
+		                             std::size_t count ) {
+			if constexpr( has_prepare_v<T> ) {
+				return WritableOutput<T>::commit( writable_value, prepared, count );
+			} else {
+				(void)writable_value;
+				(void)prepared;
+				(void)count;
+				return { IOOpStatus::Error, 0 };
+			}
+		}
+
+		/// @brief Write a list of buffers, in order, to writable_value.  This uses
+		/// WritableOutput<T>::write_vectored when the specialization has it and
+		/// falls back to writing each buffer in turn.
+		/// @return The total bytes written, stopping at the first failing buffer
+		template<typename T, typename Buffer>
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( T &writable_value, std::span<Buffer const> buffers ) {
+			if constexpr( has_write_vectored_v<T, Buffer> ) {
+				return WritableOutput<T>::write_vectored( writable_value, buffers );
+			} else {
+				std::size_t written = 0;
+				for( Buffer const &buff : buffers ) {
+					auto const r = WritableOutput<T>::write( writable_value, buff );
+					if( r.status != IOOpStatus::Ok ) {
+						return { r.status, r.count + written };
+					}
+					written += r.count;
+				}
+				return { IOOpStatus::Ok, written };
+			}
+		}
+	} // namespace io_details
+
+	/// @brief Write size bytes produced by op.  When writer can prepare the
+	/// memory, op writes straight into the output, otherwise into a stack
+	/// buffer that is then written.
+	/// @tparam MaxSize The largest size, the size of the stack buffer
+	/// @param writer A Writer, WriteProxy or other type with write/prepare/commit
+	/// members
+	/// @param size The number of bytes op needs, at most MaxSize
+	/// @param op A callable with signature std::size_t( std::span<char> ) that
+	/// returns the number of bytes it wrote to the front of the span
+	template<std::size_t MaxSize, typename WriterT, typename Op>
+	[[nodiscard]] constexpr IOOpResult
+	write_direct( WriterT &writer, std::size_t size, Op &&op ) {
+		static_assert( MaxSize > 0 );
+		assert( size <= MaxSize );
+		if constexpr( daw::is_detected_v<io_details::has_prepare_member_test,
+		                                 WriterT> ) {
+			std::span<char> prepared = writer.prepare( size );
+			if( prepared.size( ) >= size ) {
+				std::size_t const count = op( prepared.first( size ) );
+				return writer.commit( prepared, count );
+			}
+			if( not prepared.empty( ) ) {
+				(void)writer.commit( prepared, 0 );
+			}
+		}
+		char buff[MaxSize];
+		std::size_t const count = op( std::span<char>( buff, size ) );
+		return writer.write( daw::string_view( buff, count ) );
+	}
+
+	/// @brief Let writer make room for the bytes about to be written, so that
+	/// a growable output allocates once
+	/// @param writer A Writer, WriteProxy or other type with
+	/// can_reserve/reserve members.  Other types are left as is
+	/// @param size_op A callable with signature std::size_t( ) returning the
+	/// number of bytes.  It is only called when writer can reserve
+	template<typename WriterT, typename SizeOp>
+	constexpr void reserve_for( WriterT &writer, SizeOp &&size_op ) {
+		if constexpr( daw::is_detected_v<io_details::has_can_reserve_member_test,
+		                                 WriterT> ) {
+			if( writer.can_reserve( ) ) {
+				writer.reserve( size_op( ) );
+			}
+		} else {
+			(void)writer;
+			(void)size_op;
+		}
+	}
+
+	/// @brief Write at most MaxSize bytes produced by op, see the overload
+	/// taking a size
+	template<std::size_t MaxSize, typename WriterT, typename Op>
+	[[nodiscard]] constexpr IOOpResult write_direct( WriterT &writer, Op &&op ) {
+		return write_direct<MaxSize>( writer, MaxSize, op );
+	}
 } // namespace daw::io
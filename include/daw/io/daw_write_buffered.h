@@ -0,0 +1,307 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_write_base.h"
+#include "daw_write_to_buffer.h"
+
+#include <daw/daw_string_view.h>
+#include <daw/daw_traits.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <numeric>
+#include <span>
+
+namespace daw::io {
+	/// @brief When a BufferedWriter flushes to the underlying Writable outside
+	/// of running out of buffer space, an explicit flush( ), or destruction
+	enum class BufferFlushPolicy {
+		/// Only flush when the buffer is full
+		WhenFull,
+		/// Additionally flush after any write containing a '\n'
+		OnNewline
+	};
+
+	/// @brief Coalesce many small writes to a Writable into an owned buffer so
+	/// that the underlying sink sees a few large writes.  The Writable is held
+	/// by reference and must outlive the BufferedWriter.
+	/// @tparam Writable A type with a WritableOutput specialization
+	/// @tparam BuffSize Size of the owned buffer.  Writes at least this large
+	/// bypass the buffer
+	template<typename Writable, std::size_t BuffSize = 4096U>
+	class BufferedWriter {
+		static_assert( BuffSize > 0 );
+
+		Writable *m_writable;
+		BufferFlushPolicy m_policy;
+		std::size_t m_size = 0;
+		char m_buffer[BuffSize];
+
+		[[nodiscard]] constexpr std::size_t free_space( ) const {
+			return BuffSize - m_size;
+		}
+
+		template<typename ContiguousRange>
+		constexpr void append( ContiguousRange const &r ) {
+			assert( std::size( r ) <= free_space( ) );
+			(void)io_details::write_to_buffer( m_buffer + m_size, r );
+			m_size += std::size( r );
+		}
+
+		[[nodiscard]] static constexpr bool has_newline( daw::string_view sv ) {
+			return sv.find( '\n' ) != daw::string_view::npos;
+		}
+
+		[[nodiscard]] static constexpr bool
+		has_newline( std::span<std::byte const> sp ) {
+			for( std::byte b : sp ) {
+				if( b == std::byte{ '\n' } ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		template<typename ContiguousRange>
+		[[nodiscard]] constexpr IOOpResult write_impl( ContiguousRange r ) {
+			if( std::size( r ) > free_space( ) ) {
+				auto const fr = flush( );
+				if( fr.status != IOOpStatus::Ok ) {
+					return { fr.status, 0 };
+				}
+				if( std::size( r ) >= BuffSize ) {
+					return WritableOutput<Writable>::write( *m_writable, r );
+				}
+			}
+			append( r );
+			if( m_policy == BufferFlushPolicy::OnNewline and has_newline( r ) ) {
+				auto const fr = flush( );
+				return { fr.status, std::size( r ) };
+			}
+			return { IOOpStatus::Ok, std::size( r ) };
+		}
+
+		template<typename ContiguousRange>
+		[[nodiscard]] constexpr IOOpResult
+		write_list_impl( std::span<ContiguousRange const> rs ) {
+			auto const total_sz =
+			  std::accumulate( rs.begin( ), rs.end( ), std::size_t{ 0 },
+			                   []( std::size_t sz, ContiguousRange const &r ) {
+				                   return sz + std::size( r );
+			                   } );
+			if( total_sz <= free_space( ) ) {
+				bool newline = false;
+				for( ContiguousRange const &r : rs ) {
+					append( r );
+					newline = newline or has_newline( r );
+				}
+				if( m_policy == BufferFlushPolicy::OnNewline and newline ) {
+					auto const fr = flush( );
+					return { fr.status, total_sz };
+				}
+				return { IOOpStatus::Ok, total_sz };
+			}
+			std::size_t written = 0;
+			for( ContiguousRange const &r : rs ) {
+				auto const wr = write_impl( r );
+				if( wr.status != IOOpStatus::Ok ) {
+					return { wr.status, wr.count + written };
+				}
+				written += wr.count;
+			}
+			return { IOOpStatus::Ok, written };
+		}
+
+	public:
+		explicit constexpr BufferedWriter(
+		  Writable &writable_value,
+		  BufferFlushPolicy policy = BufferFlushPolicy::WhenFull ) noexcept
+		  : m_writable( std::addressof( writable_value ) )
+		  , m_policy( policy ) {}
+
+		BufferedWriter( BufferedWriter const & ) = delete;
+		BufferedWriter &operator=( BufferedWriter const & ) = delete;
+
+		/// The buffer is flushed on destruction, errors are discarded.  Call
+		/// flush( ) first when the result matters
+		~BufferedWriter( ) {
+			(void)flush( );
+		}
+
+		/// @brief Write all buffered data to the underlying Writable.  On error,
+		/// the unwritten data remains buffered
+		/// @return The result of writing to the underlying Writable
+		[[nodiscard]] constexpr IOOpResult flush( ) {
+			if( m_size == 0 ) {
+				return { IOOpStatus::Ok, 0 };
+			}
+			auto const result = WritableOutput<Writable>::write(
+			  *m_writable, daw::string_view( m_buffer, m_size ) );
+			if( result.count >= m_size ) {
+				m_size = 0;
+			} else {
+				std::memmove( m_buffer, m_buffer + result.count,
+				              m_size - result.count );
+				m_size -= result.count;
+			}
+			return result;
+		}
+
+		/// @return The number of bytes waiting to be flushed
+		[[nodiscard]] constexpr std::size_t size( ) const {
+			return m_size;
+		}
+
+		[[nodiscard]] static constexpr std::size_t capacity( ) {
+			return BuffSize;
+		}
+
+		[[nodiscard]] constexpr BufferFlushPolicy flush_policy( ) const {
+			return m_policy;
+		}
+
+		[[nodiscard]] constexpr Writable &writable( ) const {
+			return *m_writable;
+		}
+
+		[[nodiscard]] constexpr IOOpResult write( daw::string_view sv ) {
+			return write_impl( sv );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write( std::initializer_list<daw::string_view> svs ) {
+			return write_list_impl(
+			  std::span<daw::string_view const>( svs.begin( ), svs.size( ) ) );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( std::span<daw::string_view const> svs ) {
+			return write_list_impl( svs );
+		}
+
+		[[nodiscard]] constexpr IOOpResult write( std::span<std::byte const> sp ) {
+			return write_impl( sp );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write( std::initializer_list<std::span<std::byte const>> sps ) {
+			return write_list_impl(
+			  std::span<std::span<std::byte const> const>( sps.begin( ), sps.size( ) ) );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( std::span<std::span<std::byte const> const> sps ) {
+			return write_list_impl( sps );
+		}
+
+		/// @brief Acquire n bytes of the buffer to write into directly, flushing
+		/// first when there is not enough room
+		/// @return The memory, or an empty span if n is larger than the buffer or
+		/// flushing failed
+		[[nodiscard]] constexpr std::span<char> prepare( std::size_t n ) {
+			if( n > BuffSize ) {
+				return { };
+			}
+			if( n > free_space( ) and flush( ).status != IOOpStatus::Ok ) {
+				return { };
+			}
+			return std::span<char>( m_buffer + m_size, n );
+		}
+
+		/// @brief Keep the first count bytes of the last prepare
+		constexpr IOOpResult commit( std::span<char> prepared,
+		                             std::size_t count ) {
+			assert( prepared.data( ) == m_buffer + m_size );
+			assert( count <= prepared.size( ) );
+			m_size += count;
+			if( m_policy == BufferFlushPolicy::OnNewline and
+			    has_newline( daw::string_view( prepared.data( ), count ) ) ) {
+				auto const fr = flush( );
+				return { fr.status, count };
+			}
+			return { IOOpStatus::Ok, count };
+		}
+
+		template<typename Byte>
+		[[nodiscard]] constexpr IOOpResult put( Byte b ) {
+			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
+			if( m_size == BuffSize ) {
+				auto const fr = flush( );
+				if( fr.status != IOOpStatus::Ok ) {
+					return { fr.status, 0 };
+				}
+			}
+			m_buffer[m_size++] = static_cast<char>( b );
+			if( m_policy == BufferFlushPolicy::OnNewline and
+			    static_cast<char>( b ) == '\n' ) {
+				auto const fr = flush( );
+				return { fr.status, 1 };
+			}
+			return { IOOpStatus::Ok, 1 };
+		}
+	};
+
+	template<typename Writable, std::size_t BuffSize>
+	struct WritableOutput<BufferedWriter<Writable, BuffSize>> {
+		using value_type = BufferedWriter<Writable, BuffSize>;
+
+		[[nodiscard]] static constexpr IOOpResult write( value_type &bw,
+		                                                 daw::string_view sv ) {
+			return bw.write( sv );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write( value_type &bw, std::initializer_list<daw::string_view> svs ) {
+			return bw.write( svs );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write( value_type &bw, std::span<std::byte const> sp ) {
+			return bw.write( sp );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write( value_type &bw,
+		       std::initializer_list<std::span<std::byte const>> sps ) {
+			return bw.write( sps );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write_vectored( value_type &bw, std::span<daw::string_view const> svs ) {
+			return bw.write_vectored( svs );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write_vectored( value_type &bw,
+		                std::span<std::span<std::byte const> const> sps ) {
+			return bw.write_vectored( sps );
+		}
+
+		[[nodiscard]] static constexpr std::span<char> prepare( value_type &bw,
+		                                                        std::size_t n ) {
+			return bw.prepare( n );
+		}
+
+		static constexpr IOOpResult commit( value_type &bw,
+		                                    std::span<char> prepared,
+		                                    std::size_t count ) {
+			return bw.commit( prepared, count );
+		}
+
+		template<typename Byte>
+		[[nodiscard]] static constexpr IOOpResult put( value_type &bw, Byte b ) {
+			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
+			return bw.put( b );
+		}
+	};
+} // namespace daw::io
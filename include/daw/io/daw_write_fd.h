@@ -16,14 +16,172 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <initializer_list>
+#include <iterator>
 #include <numeric>
 #include <span>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace daw::io {
+	namespace io_details {
+#if defined( IOV_MAX )
+		inline constexpr std::size_t fd_iov_max = IOV_MAX;
+#else
+		inline constexpr std::size_t fd_iov_max = 16U;
+#endif
+		/// The number of iovec's submitted per writev call.  Larger lists are
+		/// written in chunks of this size
+		inline constexpr std::size_t fd_iov_batch_size =
+		  std::min( fd_iov_max, std::size_t{ 64U } );
+
+		/// @brief Gather write all the buffers with as few calls of
+		/// write_batch( iovs, iov_count, bytes_written_so_far ), e.g. writev, as
+		/// possible.  Partial writes resume from the buffer and offset where the
+		/// kernel stopped.
+		template<typename Buffer, typename WriteBatch>
+		[[nodiscard]] inline IOOpResult
+		fd_gather_write( std::span<Buffer const> buffers, WriteBatch write_batch ) {
+			::iovec iovs[fd_iov_batch_size];
+			std::size_t idx = 0;
+			std::size_t offset = 0;
+			std::size_t total = 0;
+			while( idx < buffers.size( ) ) {
+				int iov_count = 0;
+				for( std::size_t n = idx; n < buffers.size( ) and
+				                          static_cast<std::size_t>( iov_count ) <
+				                            fd_iov_batch_size;
+				     ++n ) {
+					auto const skip = n == idx ? offset : std::size_t{ 0 };
+					auto const sz = std::size( buffers[n] ) - skip;
+					if( sz == 0 ) {
+						continue;
+					}
+					auto const *ptr =
+					  reinterpret_cast<char const *>( std::data( buffers[n] ) );
+					iovs[iov_count++] = ::iovec{ const_cast<char *>( ptr + skip ), sz };
+				}
+				if( iov_count == 0 ) {
+					break;
+				}
+				auto const result = write_batch( iovs, iov_count, total );
+				if( result <= 0 ) {
+					if( result < 0 and errno == EINTR ) {
+						continue;
+					}
+					return { IOOpStatus::Error, total };
+				}
+				auto written = static_cast<std::size_t>( result );
+				total += written;
+				while( written > 0 ) {
+					auto const remaining = std::size( buffers[idx] ) - offset;
+					if( written < remaining ) {
+						offset += written;
+						break;
+					}
+					written -= remaining;
+					offset = 0;
+					++idx;
+				}
+			}
+			return { IOOpStatus::Ok, total };
+		}
+
+		/// @brief Gather write all the buffers to fd with as few writev calls as
+		/// possible
+		template<typename Buffer>
+		[[nodiscard]] inline IOOpResult
+		fd_write_vectored( int fd, std::span<Buffer const> buffers ) {
+			return fd_gather_write(
+			  buffers, [fd]( ::iovec const *iovs, int iov_count, std::size_t ) {
+				  return ::writev( fd, iovs, iov_count );
+			  } );
+		}
+
+		/// @brief Gather write all the buffers to fd at offset with as few
+		/// pwritev calls as possible
+		template<typename Buffer>
+		[[nodiscard]] inline IOOpResult
+		fd_pwrite_vectored( int fd, std::uint64_t offset,
+		                    std::span<Buffer const> buffers ) {
+			return fd_gather_write(
+			  buffers,
+			  [fd, offset]( ::iovec const *iovs, int iov_count, std::size_t done ) {
+				  return ::pwritev( fd, iovs, iov_count,
+				                    static_cast<::off_t>( offset + done ) );
+			  } );
+		}
+
+		/// @brief Write all of buff to fd at offset
+		[[nodiscard]] inline IOOpResult fd_pwrite( int fd, std::uint64_t offset,
+		                                           void const *buff,
+		                                           std::size_t size ) {
+			auto const *ptr = static_cast<char const *>( buff );
+			std::size_t total = 0;
+			while( total < size ) {
+				auto const result =
+				  ::pwrite( fd, ptr + total, size - total,
+				            static_cast<::off_t>( offset + total ) );
+				if( result <= 0 ) {
+					if( result < 0 and errno == EINTR ) {
+						continue;
+					}
+					return { IOOpStatus::Error, total };
+				}
+				total += static_cast<std::size_t>( result );
+			}
+			return { IOOpStatus::Ok, total };
+		}
+
+		/// @brief Write r at fd's offset and advance it.  Writes past end stop at
+		/// end and return Error
+		template<typename ContiguousRange>
+		[[nodiscard]] inline IOOpResult
+		fd_at_offset_write( fd_at_offset &fd, ContiguousRange const &r ) {
+			auto const len = static_cast<std::size_t>(
+			  std::min<std::uint64_t>( std::size( r ), fd.remaining( ) ) );
+			auto result = fd_pwrite( fd.value, fd.offset, std::data( r ), len );
+			fd.offset += result.count;
+			if( len < std::size( r ) ) {
+				result.status = IOOpStatus::Error;
+			}
+			return result;
+		}
+
+		/// @brief Gather write the buffers at fd's offset and advance it.  Writes
+		/// past end stop at end and return Error
+		template<typename Buffer>
+		[[nodiscard]] inline IOOpResult
+		fd_at_offset_write_vectored( fd_at_offset &fd,
+		                             std::span<Buffer const> buffers ) {
+			auto const total_sz =
+			  std::accumulate( buffers.begin( ), buffers.end( ), std::uint64_t{ 0 },
+			                   []( std::uint64_t sz, Buffer const &b ) {
+				                   return sz + std::size( b );
+			                   } );
+			if( total_sz > fd.remaining( ) ) {
+				// Write what fits, one buffer at a time
+				std::size_t written = 0;
+				for( Buffer const &b : buffers ) {
+					auto const r = fd_at_offset_write( fd, b );
+					written += r.count;
+					if( r.status != IOOpStatus::Ok ) {
+						return { r.status, written };
+					}
+				}
+				return { IOOpStatus::Ok, written };
+			}
+			auto const result = fd_pwrite_vectored( fd.value, fd.offset, buffers );
+			fd.offset += result.count;
+			return result;
+		}
+	} // namespace io_details
+
 	template<>
 	struct WritableOutput<fd_wrap_t> {
 		[[nodiscard]] static inline IOOpResult write( fd_wrap_t fd,
@@ -48,15 +206,13 @@ namespace daw::io {
 
 		[[nodiscard]] static inline IOOpResult
 		write( fd_wrap_t fd, std::initializer_list<daw::string_view> svs ) {
-			std::size_t written = 0;
-			for( daw::string_view const &sv : svs ) {
-				auto const r = WritableOutput::write( fd, sv );
-				if( r.status != IOOpStatus::Ok ) {
-					return { r.status, r.count + written };
-				}
-				written += r.count;
-			}
-			return { IOOpStatus::Ok, written };
+			return io_details::fd_write_vectored(
+			  fd.value, std::span<daw::string_view const>( svs.begin( ), svs.size( ) ) );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write_vectored( fd_wrap_t fd, std::span<daw::string_view const> svs ) {
+			return io_details::fd_write_vectored( fd.value, svs );
 		}
 
 		[[nodiscard]] static inline IOOpResult
@@ -79,18 +235,18 @@ namespace daw::io {
 			return { IOOpStatus::Ok, 0 };
 		}
 
-		static constexpr IOOpResult
+		[[nodiscard]] static inline IOOpResult
 		write( fd_wrap_t fd,
 		       std::initializer_list<std::span<std::byte const>> sps ) {
-			std::size_t written = 0;
-			for( std::span<std::byte const> const &sp : sps ) {
-				auto const r = WritableOutput::write( fd, sp );
-				if( r.status != IOOpStatus::Ok ) {
-					return { r.status, r.count + written };
-				}
-				written += r.count;
-			}
-			return { IOOpStatus::Ok, written };
+			return io_details::fd_write_vectored(
+			  fd.value,
+			  std::span<std::span<std::byte const> const>( sps.begin( ), sps.size( ) ) );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write_vectored( fd_wrap_t fd,
+		                std::span<std::span<std::byte const> const> sps ) {
+			return io_details::fd_write_vectored( fd.value, sps );
 		}
 
 		template<typename B>
@@ -100,4 +256,52 @@ namespace daw::io {
 			return WritableOutput::write( fd, std::span<std::byte const>( &byte, 1 ) );
 		}
 	};
+
+	/// @brief Write at, and advance, the offset of an fd_at_offset with pwrite.
+	/// Writes past end stop at end and return Error
+	template<>
+	struct WritableOutput<fd_at_offset> {
+		[[nodiscard]] static inline IOOpResult write( fd_at_offset &fd,
+		                                              daw::string_view sv ) {
+			return io_details::fd_at_offset_write( fd, sv );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( fd_at_offset &fd, std::initializer_list<daw::string_view> svs ) {
+			return io_details::fd_at_offset_write_vectored(
+			  fd, std::span<daw::string_view const>( svs.begin( ), svs.size( ) ) );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write_vectored( fd_at_offset &fd, std::span<daw::string_view const> svs ) {
+			return io_details::fd_at_offset_write_vectored( fd, svs );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( fd_at_offset &fd, std::span<std::byte const> sp ) {
+			return io_details::fd_at_offset_write( fd, sp );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( fd_at_offset &fd,
+		       std::initializer_list<std::span<std::byte const>> sps ) {
+			return io_details::fd_at_offset_write_vectored(
+			  fd,
+			  std::span<std::span<std::byte const> const>( sps.begin( ), sps.size( ) ) );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write_vectored( fd_at_offset &fd,
+		                std::span<std::span<std::byte const> const> sps ) {
+			return io_details::fd_at_offset_write_vectored( fd, sps );
+		}
+
+		template<typename B>
+		[[nodiscard]] static inline IOOpResult put( fd_at_offset &fd, B b ) {
+			static_assert( daw::traits::is_one_of_v<B, char, std::byte> );
+			auto const byte = static_cast<std::byte>( b );
+			return io_details::fd_at_offset_write(
+			  fd, std::span<std::byte const>( &byte, 1 ) );
+		}
+	};
 } // namespace daw::io
@@ -0,0 +1,341 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_fd_wrap.h"
+#include "daw_write_base.h"
+#include "daw_write_to_buffer.h"
+
+#include <daw/daw_string_view.h>
+#include <daw/daw_traits.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <initializer_list>
+#include <numeric>
+#include <span>
+#include <utility>
+
+#if not __has_include( <sys/mman.h> )
+#error mmap is only supported when sys/mman.h is present
+#endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace daw::io {
+	/// @brief Write to a file through a shared memory mapping.  The file is
+	/// allocated ahead of the data and grows geometrically, being remapped as
+	/// needed.  close( ), or destruction, truncates the file to the bytes
+	/// written.
+	class mmap_writer {
+		int m_fd = -1;
+		bool m_owns_fd = false;
+		char *m_data = nullptr;
+		std::size_t m_capacity = 0;
+		std::size_t m_size = 0;
+
+		[[nodiscard]] static std::size_t round_to_page( std::size_t n ) {
+			auto const page_size =
+			  static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+			return ( ( n + page_size - 1 ) / page_size ) * page_size;
+		}
+
+		[[nodiscard]] bool resize_file( std::size_t new_capacity ) {
+			// Allocate the blocks up front where the filesystem can so that running
+			// out of space is an error here and not a SIGBUS when writing.  Only a
+			// filesystem without fallocate support falls back to a sparse file
+			auto const len = static_cast<::off_t>( new_capacity );
+			int const err = ::posix_fallocate( m_fd, 0, len );
+			if( err == 0 ) {
+				return true;
+			}
+			if( err != EOPNOTSUPP and err != EINVAL ) {
+				return false;
+			}
+			return ::ftruncate( m_fd, len ) == 0;
+		}
+
+		[[nodiscard]] bool grow( std::size_t needed ) {
+			if( m_fd < 0 ) {
+				return false;
+			}
+			auto const new_capacity = round_to_page(
+			  std::max( { needed, m_capacity * 2, std::size_t{ 1 } } ) );
+			if( not resize_file( new_capacity ) ) {
+				return false;
+			}
+			void *ptr = MAP_FAILED;
+			if( m_data == nullptr ) {
+				ptr = ::mmap( nullptr, new_capacity, PROT_READ | PROT_WRITE,
+				              MAP_SHARED, m_fd, 0 );
+			} else {
+#if defined( __linux__ )
+				ptr = ::mremap( m_data, m_capacity, new_capacity, MREMAP_MAYMOVE );
+#else
+				if( ::munmap( m_data, m_capacity ) == 0 ) {
+					m_data = nullptr;
+					ptr = ::mmap( nullptr, new_capacity, PROT_READ | PROT_WRITE,
+					              MAP_SHARED, m_fd, 0 );
+				}
+#endif
+			}
+			if( ptr == MAP_FAILED ) {
+				return false;
+			}
+			m_data = static_cast<char *>( ptr );
+			m_capacity = new_capacity;
+			return true;
+		}
+
+		template<typename ContiguousRange>
+		[[nodiscard]] IOOpResult write_impl( ContiguousRange const &r ) {
+			if( not reserve( std::size( r ) ) ) {
+				return { IOOpStatus::Error, 0 };
+			}
+			(void)io_details::write_to_buffer( m_data + m_size, r );
+			m_size += std::size( r );
+			return { IOOpStatus::Ok, std::size( r ) };
+		}
+
+		template<typename ContiguousRange>
+		[[nodiscard]] IOOpResult
+		write_vectored_impl( std::span<ContiguousRange const> rs ) {
+			auto const total_sz =
+			  std::accumulate( rs.begin( ), rs.end( ), std::size_t{ 0 },
+			                   []( std::size_t sz, ContiguousRange const &r ) {
+				                   return sz + std::size( r );
+			                   } );
+			if( not reserve( total_sz ) ) {
+				return { IOOpStatus::Error, 0 };
+			}
+			for( ContiguousRange const &r : rs ) {
+				(void)io_details::write_to_buffer( m_data + m_size, r );
+				m_size += std::size( r );
+			}
+			return { IOOpStatus::Ok, total_sz };
+		}
+
+	public:
+		static constexpr std::size_t default_initial_capacity = 1024U * 1024U;
+
+		explicit mmap_writer( ) = default;
+
+		/// @brief Create, or truncate, the file at path and map it
+		/// @param initial_capacity The initial file size to allocate and map
+		explicit mmap_writer(
+		  std::filesystem::path const &path,
+		  std::size_t initial_capacity = default_initial_capacity )
+		  : m_fd( ::open( path.c_str( ), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+		                  0644 ) )
+		  , m_owns_fd( true ) {
+			if( m_fd >= 0 and not grow( initial_capacity ) ) {
+				(void)close( );
+			}
+		}
+
+		/// @brief Write to the file open for reading and writing at fd, starting at
+		/// offset 0.  The fd remains owned by the caller
+		explicit mmap_writer( fd_wrap_t fd,
+		                      std::size_t initial_capacity = default_initial_capacity )
+		  : m_fd( fd.value ) {
+			struct ::stat st { };
+			bool const has_size = ::fstat( m_fd, &st ) == 0;
+			if( not grow( initial_capacity ) ) {
+				// close( ) would truncate the caller's file to 0 bytes, e.g. when
+				// it is open write only and cannot be mapped.  Put back its size
+				if( has_size ) {
+					(void)::ftruncate( m_fd, st.st_size );
+				}
+				if( m_data != nullptr ) {
+					::munmap( m_data, m_capacity );
+					m_data = nullptr;
+				}
+				m_fd = -1;
+				m_capacity = 0;
+			}
+		}
+
+		mmap_writer( mmap_writer const & ) = delete;
+		mmap_writer &operator=( mmap_writer const & ) = delete;
+
+		mmap_writer( mmap_writer &&other ) noexcept
+		  : m_fd( std::exchange( other.m_fd, -1 ) )
+		  , m_owns_fd( std::exchange( other.m_owns_fd, false ) )
+		  , m_data( std::exchange( other.m_data, nullptr ) )
+		  , m_capacity( std::exchange( other.m_capacity, 0 ) )
+		  , m_size( std::exchange( other.m_size, 0 ) ) {}
+
+		mmap_writer &operator=( mmap_writer &&rhs ) noexcept {
+			if( this != &rhs ) {
+				(void)close( );
+				m_fd = std::exchange( rhs.m_fd, -1 );
+				m_owns_fd = std::exchange( rhs.m_owns_fd, false );
+				m_data = std::exchange( rhs.m_data, nullptr );
+				m_capacity = std::exchange( rhs.m_capacity, 0 );
+				m_size = std::exchange( rhs.m_size, 0 );
+			}
+			return *this;
+		}
+
+		~mmap_writer( ) {
+			(void)close( );
+		}
+
+		/// @brief Unmap the file, truncate it to the bytes written and close it if
+		/// owned
+		/// @return Error if truncating or closing failed
+		IOOpResult close( ) {
+			auto status = IOOpStatus::Ok;
+			if( m_data != nullptr ) {
+				::munmap( m_data, m_capacity );
+				m_data = nullptr;
+			}
+			if( m_fd >= 0 ) {
+				if( ::ftruncate( m_fd, static_cast<::off_t>( m_size ) ) != 0 ) {
+					status = IOOpStatus::Error;
+				}
+				if( m_owns_fd and ::close( m_fd ) != 0 ) {
+					status = IOOpStatus::Error;
+				}
+			}
+			auto const written = m_size;
+			m_fd = -1;
+			m_owns_fd = false;
+			m_capacity = 0;
+			m_size = 0;
+			return { status, written };
+		}
+
+		[[nodiscard]] bool is_open( ) const {
+			return m_data != nullptr;
+		}
+
+		/// @return The bytes written so far
+		[[nodiscard]] std::size_t size( ) const {
+			return m_size;
+		}
+
+		/// @return The currently mapped size of the file
+		[[nodiscard]] std::size_t capacity( ) const {
+			return m_capacity;
+		}
+
+		/// @brief Ensure n more bytes can be written without remapping
+		/// @return false if the file could not be grown or remapped
+		[[nodiscard]] bool reserve( std::size_t n ) {
+			if( m_data == nullptr ) {
+				return false;
+			}
+			if( m_capacity - m_size >= n ) {
+				return true;
+			}
+			return grow( m_size + n );
+		}
+
+		[[nodiscard]] IOOpResult write( daw::string_view sv ) {
+			return write_impl( sv );
+		}
+
+		[[nodiscard]] IOOpResult write( std::span<std::byte const> sp ) {
+			return write_impl( sp );
+		}
+
+		[[nodiscard]] IOOpResult
+		write_vectored( std::span<daw::string_view const> svs ) {
+			return write_vectored_impl( svs );
+		}
+
+		[[nodiscard]] IOOpResult
+		write_vectored( std::span<std::span<std::byte const> const> sps ) {
+			return write_vectored_impl( sps );
+		}
+
+		[[nodiscard]] std::span<char> prepare( std::size_t n ) {
+			if( not reserve( n ) ) {
+				return { };
+			}
+			return std::span<char>( m_data + m_size, n );
+		}
+
+		IOOpResult commit( std::span<char> prepared, std::size_t count ) {
+			assert( prepared.data( ) == m_data + m_size );
+			assert( count <= prepared.size( ) );
+			(void)prepared;
+			m_size += count;
+			return { IOOpStatus::Ok, count };
+		}
+
+		template<typename Byte>
+		[[nodiscard]] IOOpResult put( Byte b ) {
+			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
+			if( not reserve( 1 ) ) {
+				return { IOOpStatus::Error, 0 };
+			}
+			m_data[m_size++] = static_cast<char>( b );
+			return { IOOpStatus::Ok, 1 };
+		}
+	};
+
+	template<>
+	struct WritableOutput<mmap_writer> {
+		[[nodiscard]] static inline IOOpResult write( mmap_writer &mw,
+		                                              daw::string_view sv ) {
+			return mw.write( sv );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( mmap_writer &mw, std::initializer_list<daw::string_view> svs ) {
+			return mw.write_vectored(
+			  std::span<daw::string_view const>( svs.begin( ), svs.size( ) ) );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( mmap_writer &mw, std::span<std::byte const> sp ) {
+			return mw.write( sp );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( mmap_writer &mw,
+		       std::initializer_list<std::span<std::byte const>> sps ) {
+			return mw.write_vectored(
+			  std::span<std::span<std::byte const> const>( sps.begin( ), sps.size( ) ) );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write_vectored( mmap_writer &mw, std::span<daw::string_view const> svs ) {
+			return mw.write_vectored( svs );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write_vectored( mmap_writer &mw,
+		                std::span<std::span<std::byte const> const> sps ) {
+			return mw.write_vectored( sps );
+		}
+
+		[[nodiscard]] static inline std::span<char> prepare( mmap_writer &mw,
+		                                                     std::size_t n ) {
+			return mw.prepare( n );
+		}
+
+		static inline IOOpResult commit( mmap_writer &mw, std::span<char> prepared,
+		                                 std::size_t count ) {
+			return mw.commit( prepared, count );
+		}
+
+		template<typename Byte>
+		[[nodiscard]] static inline IOOpResult put( mmap_writer &mw, Byte b ) {
+			return mw.put( b );
+		}
+	};
+} // namespace daw::io
@@ -65,6 +65,21 @@ namespace daw::io {
 			return { IOOpStatus::Ok, written };
 		}
 
+		/// The destination is unbounded, as with write, so the caller must ensure
+		/// there is room for n bytes
+		[[nodiscard]] static inline std::span<char> prepare( Byte *&ptr,
+		                                                     std::size_t n ) {
+			return std::span<char>( reinterpret_cast<char *>( ptr ), n );
+		}
+
+		static inline IOOpResult commit( Byte *&ptr, std::span<char> prepared,
+		                                 std::size_t count ) {
+			assert( count <= prepared.size( ) );
+			(void)prepared;
+			ptr += count;
+			return { IOOpStatus::Ok, count };
+		}
+
 		template<typename B>
 		[[nodiscard]] static inline IOOpResult put( Byte *&ptr, B b ) {
 			static_assert( daw::traits::is_one_of_v<B, char, std::byte> );
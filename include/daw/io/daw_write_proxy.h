@@ -12,170 +12,233 @@
 
 #include <daw/daw_assume.h>
 #include <daw/daw_string_view.h>
-#include <daw/daw_unique_ptr.h>
 
+#include <cassert>
 #include <cstddef>
 #include <initializer_list>
+#include <memory>
 #include <span>
+#include <type_traits>
 
 namespace daw::io {
+	/// @brief A non-owning handle to a Writable.  It is trivially copyable and
+	/// the Writable must outlive it
 	template<typename Writable>
 	class Writer {
-		struct data_t {
-			Writable &writable_value;
-		};
-		daw::unique_ptr<data_t> data{ };
+		Writable *m_writable;
 
 	public:
 		constexpr Writer( Writable &writable_value ) noexcept
-		  : data( daw::make_unique<data_t>( writable_value ) ) {}
+		  : m_writable( std::addressof( writable_value ) ) {}
+
+		[[nodiscard]] constexpr Writable &writable( ) const noexcept {
+			return *m_writable;
+		}
 
 		[[nodiscard]] constexpr IOOpResult write( daw::string_view sv ) {
-			return WritableOutput<Writable>::write( data->writable_value, sv );
+			return WritableOutput<Writable>::write( *m_writable, sv );
 		}
 
 		[[nodiscard]] constexpr IOOpResult
 		write( std::initializer_list<daw::string_view> const &svs ) {
-			return WritableOutput<Writable>::write( data->writable_value, svs );
+			return WritableOutput<Writable>::write( *m_writable, svs );
 		}
 
 		[[nodiscard]] constexpr IOOpResult write( std::span<std::byte const> sp ) {
-			return WritableOutput<Writable>::write( data->writable_value, sp );
+			return WritableOutput<Writable>::write( *m_writable, sp );
 		}
 
 		[[nodiscard]] constexpr IOOpResult
 		write( std::initializer_list<std::span<std::byte const>> const &sps ) {
-			return WritableOutput<Writable>::write( data->writable_value, sps );
+			return WritableOutput<Writable>::write( *m_writable, sps );
+		}
+
+		/// @brief Write a runtime sized list of buffers.  Sinks that can, e.g.
+		/// file descriptors via writev, will do this in a single operation
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( std::span<daw::string_view const> svs ) {
+			return io_details::write_vectored( *m_writable, svs );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( std::span<std::span<std::byte const> const> sps ) {
+			return io_details::write_vectored( *m_writable, sps );
+		}
+
+		/// @brief Acquire n bytes of the output to write into directly
+		/// @return The memory, or an empty span when the Writable cannot
+		[[nodiscard]] constexpr std::span<char> prepare( std::size_t n ) {
+			return io_details::prepare( *m_writable, n );
+		}
+
+		/// @brief Keep the first count bytes of the span from the last prepare
+		constexpr IOOpResult commit( std::span<char> prepared, std::size_t count ) {
+			return io_details::commit( *m_writable, prepared, count );
+		}
+
+		/// @return Whether reserve can make room in the Writable
+		[[nodiscard]] static constexpr bool can_reserve( ) {
+			return has_reserve_v<Writable>;
+		}
+
+		/// @brief Make room for n more bytes of output, when the Writable
+		/// supports it
+		constexpr void reserve( std::size_t n ) {
+			io_details::reserve( *m_writable, n );
 		}
 
 		[[nodiscard]] constexpr IOOpResult put( std::byte b ) {
-			return WritableOutput<Writable>::put( data->writable_value, b );
+			return WritableOutput<Writable>::put( *m_writable, b );
 		}
 
 		[[nodiscard]] constexpr IOOpResult put( char c ) {
-			return WritableOutput<Writable>::put( data->writable_value, c );
+			return WritableOutput<Writable>::put( *m_writable, c );
 		}
 	};
 	template<typename Writable>
 	Writer( Writable ) -> Writer<Writable>;
 
 	namespace io_details {
-		struct WriteProxyImpl {
-			explicit WriteProxyImpl( ) = default;
-			constexpr virtual ~WriteProxyImpl( ) = default;
-
-			[[nodiscard]] constexpr virtual daw::unique_ptr<WriteProxyImpl>
-			clone( ) const = 0;
-			[[nodiscard]] constexpr virtual IOOpResult write( daw::string_view ) = 0;
-			[[nodiscard]] constexpr virtual IOOpResult
-			write( std::initializer_list<daw::string_view> const & ) = 0;
-			[[nodiscard]] constexpr virtual IOOpResult
-			  write( std::span<std::byte const> ) = 0;
-			[[nodiscard]] constexpr virtual IOOpResult
-			write( std::initializer_list<std::span<std::byte const>> const & ) = 0;
-			[[nodiscard]] constexpr virtual IOOpResult put( std::byte ) = 0;
-			[[nodiscard]] constexpr virtual IOOpResult put( char ) = 0;
+		/// @brief The operations of a WriteProxy.  There is one static instance per
+		/// Writable type, so a WriteProxy is a pointer to it and a pointer to the
+		/// Writable
+		struct write_proxy_vtable_t {
+			IOOpResult ( *write_sv )( void *, daw::string_view );
+			IOOpResult ( *write_svs )(
+			  void *, std::initializer_list<daw::string_view> const & );
+			IOOpResult ( *write_sp )( void *, std::span<std::byte const> );
+			IOOpResult ( *write_sps )(
+			  void *, std::initializer_list<std::span<std::byte const>> const & );
+			IOOpResult ( *write_vectored_svs )( void *,
+			                                     std::span<daw::string_view const> );
+			IOOpResult ( *write_vectored_sps )(
+			  void *, std::span<std::span<std::byte const> const> );
+			std::span<char> ( *prepare )( void *, std::size_t );
+			IOOpResult ( *commit )( void *, std::span<char>, std::size_t );
+			void ( *reserve )( void *, std::size_t );
+			bool can_reserve;
+			IOOpResult ( *put_byte )( void *, std::byte );
+			IOOpResult ( *put_char )( void *, char );
 		};
 
-		namespace {
-			template<typename T>
-			class WriteProxyImplChild final : public WriteProxyImpl {
-				T &writer;
-
-			public:
-				[[nodiscard]] constexpr daw::unique_ptr<WriteProxyImpl>
-				clone( ) const final;
-
-				constexpr WriteProxyImplChild( T &writable_value ) noexcept
-				  : writer( writable_value ) {}
-
-				[[nodiscard]] constexpr IOOpResult write( daw::string_view sv ) final {
-					return WritableOutput<T>::write( writer, sv );
-				}
-
-				[[nodiscard]] constexpr IOOpResult
-				write( std::initializer_list<daw::string_view> const &svs ) final {
-					return WritableOutput<T>::write( writer, svs );
-				}
-
-				[[nodiscard]] constexpr IOOpResult
-				write( std::span<std::byte const> sp ) final {
-					return WritableOutput<T>::write( writer, sp );
-				}
-
-				[[nodiscard]] constexpr IOOpResult write(
-				  std::initializer_list<std::span<std::byte const>> const &sps ) final {
-					return WritableOutput<T>::write( writer, sps );
-				}
-
-				[[nodiscard]] constexpr IOOpResult put( std::byte b ) override {
-					return WritableOutput<T>::put( writer, b );
-				}
-
-				[[nodiscard]] constexpr IOOpResult put( char c ) override {
-					return WritableOutput<T>::put( writer, c );
-				}
-			};
-
-			template<typename T>
-			constexpr daw::unique_ptr<WriteProxyImpl>
-			WriteProxyImplChild<T>::clone( ) const {
-				return daw::make_unique<WriteProxyImplChild<T>>( writer );
-			}
-		} // namespace
-	}   // namespace io_details
+		template<typename T>
+		inline constexpr write_proxy_vtable_t write_proxy_vtable = {
+		  []( void *w, daw::string_view sv ) -> IOOpResult {
+			  return WritableOutput<T>::write( *static_cast<T *>( w ), sv );
+		  },
+		  []( void *w,
+		      std::initializer_list<daw::string_view> const &svs ) -> IOOpResult {
+			  return WritableOutput<T>::write( *static_cast<T *>( w ), svs );
+		  },
+		  []( void *w, std::span<std::byte const> sp ) -> IOOpResult {
+			  return WritableOutput<T>::write( *static_cast<T *>( w ), sp );
+		  },
+		  []( void *w, std::initializer_list<std::span<std::byte const>> const &sps )
+		    -> IOOpResult {
+			  return WritableOutput<T>::write( *static_cast<T *>( w ), sps );
+		  },
+		  []( void *w, std::span<daw::string_view const> svs ) -> IOOpResult {
+			  return io_details::write_vectored( *static_cast<T *>( w ), svs );
+		  },
+		  []( void *w,
+		      std::span<std::span<std::byte const> const> sps ) -> IOOpResult {
+			  return io_details::write_vectored( *static_cast<T *>( w ), sps );
+		  },
+		  []( void *w, std::size_t n ) -> std::span<char> {
+			  return io_details::prepare( *static_cast<T *>( w ), n );
+		  },
+		  []( void *w, std::span<char> prepared, std::size_t count ) -> IOOpResult {
+			  return io_details::commit( *static_cast<T *>( w ), prepared, count );
+		  },
+		  []( void *w, std::size_t n ) {
+			  io_details::reserve( *static_cast<T *>( w ), n );
+		  },
+		  has_reserve_v<T>,
+		  []( void *w, std::byte b ) -> IOOpResult {
+			  return WritableOutput<T>::put( *static_cast<T *>( w ), b );
+		  },
+		  []( void *w, char c ) -> IOOpResult {
+			  return WritableOutput<T>::put( *static_cast<T *>( w ), c );
+		  } };
+	} // namespace io_details
+
+	/// @brief A type erased, non-owning, reference to a Writable.  It does not
+	/// allocate and is trivially copyable.  The Writable must outlive it
 	class WriteProxy {
-		daw::unique_ptr<io_details::WriteProxyImpl> writer;
+		io_details::write_proxy_vtable_t const *m_vtable = nullptr;
+		void *m_writable = nullptr;
 
 	public:
 		template<typename T>
-		explicit constexpr WriteProxy( T &writable_value )
-		  : writer( daw::make_unique<io_details::WriteProxyImplChild<T>>(
-		      writable_value ) ) {}
-
-		constexpr WriteProxy( WriteProxy const &other )
-		  : writer( other.writer ? other.writer->clone( ) : nullptr ) {}
+		explicit constexpr WriteProxy( T &writable_value ) noexcept
+		  : m_vtable( std::addressof( io_details::write_proxy_vtable<T> ) )
+		  , m_writable( std::addressof( writable_value ) ) {}
 
-		constexpr WriteProxy &operator=( WriteProxy const &rhs ) {
-			if( not rhs.writer ) {
-				writer.reset( );
-			} else {
-				writer = rhs.writer->clone( );
-			}
-			return *this;
-		}
-
-		constexpr WriteProxy( WriteProxy && ) noexcept = default;
-		constexpr WriteProxy &operator=( WriteProxy && ) noexcept = default;
 		constexpr WriteProxy( ) = default;
 
 		[[nodiscard]] constexpr IOOpResult write( daw::string_view sv ) {
-			assert( writer );
-			return writer->write( sv );
+			assert( m_vtable );
+			return m_vtable->write_sv( m_writable, sv );
 		}
 
 		[[nodiscard]] constexpr IOOpResult
 		write( std::initializer_list<daw::string_view> const &svs ) {
-			assert( writer );
-			return writer->write( svs );
+			assert( m_vtable );
+			return m_vtable->write_svs( m_writable, svs );
 		}
 
 		[[nodiscard]] constexpr IOOpResult write( std::span<std::byte const> sp ) {
-			assert( writer );
-			return writer->write( sp );
+			assert( m_vtable );
+			return m_vtable->write_sp( m_writable, sp );
 		}
 
 		[[nodiscard]] constexpr IOOpResult
 		write( std::initializer_list<std::span<std::byte const>> const &sps ) {
-			assert( writer );
-			return writer->write( sps );
+			assert( m_vtable );
+			return m_vtable->write_sps( m_writable, sps );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( std::span<daw::string_view const> svs ) {
+			assert( m_vtable );
+			return m_vtable->write_vectored_svs( m_writable, svs );
+		}
+
+		[[nodiscard]] constexpr IOOpResult
+		write_vectored( std::span<std::span<std::byte const> const> sps ) {
+			assert( m_vtable );
+			return m_vtable->write_vectored_sps( m_writable, sps );
+		}
+
+		[[nodiscard]] constexpr std::span<char> prepare( std::size_t n ) {
+			assert( m_vtable );
+			return m_vtable->prepare( m_writable, n );
+		}
+
+		constexpr IOOpResult commit( std::span<char> prepared, std::size_t count ) {
+			assert( m_vtable );
+			return m_vtable->commit( m_writable, prepared, count );
+		}
+
+		[[nodiscard]] constexpr bool can_reserve( ) const {
+			assert( m_vtable );
+			return m_vtable->can_reserve;
+		}
+
+		constexpr void reserve( std::size_t n ) {
+			assert( m_vtable );
+			m_vtable->reserve( m_writable, n );
 		}
 
 		template<typename Byte>
 		[[nodiscard]] constexpr IOOpResult put( Byte b ) {
 			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
-			assert( writer );
-			return writer->put( b );
+			assert( m_vtable );
+			if constexpr( std::is_same_v<Byte, std::byte> ) {
+				return m_vtable->put_byte( m_writable, b );
+			} else {
+				return m_vtable->put_char( m_writable, b );
+			}
 		}
 	};
 
@@ -207,6 +270,34 @@ namespace daw::io {
 			return writer.write( sps );
 		}
 
+		[[nodiscard]] DAW_ATTRIB_INLINE constexpr IOOpResult
+		write_vectored( std::span<daw::string_view const> svs ) {
+			return writer.write_vectored( svs );
+		}
+
+		[[nodiscard]] DAW_ATTRIB_INLINE constexpr IOOpResult
+		write_vectored( std::span<std::span<std::byte const> const> sps ) {
+			return writer.write_vectored( sps );
+		}
+
+		[[nodiscard]] DAW_ATTRIB_INLINE constexpr std::span<char>
+		prepare( std::size_t n ) {
+			return writer.prepare( n );
+		}
+
+		DAW_ATTRIB_INLINE constexpr IOOpResult commit( std::span<char> prepared,
+		                                               std::size_t count ) {
+			return writer.commit( prepared, count );
+		}
+
+		[[nodiscard]] DAW_ATTRIB_INLINE constexpr bool can_reserve( ) const {
+			return writer.can_reserve( );
+		}
+
+		DAW_ATTRIB_INLINE constexpr void reserve( std::size_t n ) {
+			writer.reserve( n );
+		}
+
 		template<typename Byte>
 		[[nodiscard]] DAW_ATTRIB_INLINE constexpr IOOpResult put( Byte b ) {
 			static_assert( daw::traits::is_one_of_v<Byte, std::byte, char> );
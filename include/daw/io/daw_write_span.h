@@ -15,11 +15,13 @@
 #include <daw/daw_string_view.h>
 
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <initializer_list>
 #include <numeric>
 #include <span>
 #include <string_view>
+#include <type_traits>
 
 namespace daw::io {
 	template<typename CharT, std::size_t Extent>
@@ -30,6 +32,12 @@ namespace daw::io {
 
 		[[nodiscard]] static constexpr IOOpResult
 		write( value_type &s, std::initializer_list<daw::string_view> svs ) {
+			return write_vectored(
+			  s, std::span<daw::string_view const>( svs.begin( ), svs.size( ) ) );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write_vectored( value_type &s, std::span<daw::string_view const> svs ) {
 			auto const total_sz =
 			  std::accumulate( svs.begin( ), svs.end( ), std::size_t{ 0 },
 			                   []( std::size_t sz, daw::string_view sv ) {
@@ -69,10 +77,18 @@ namespace daw::io {
 		[[nodiscard]] static constexpr IOOpResult
 		write( value_type &s,
 		       std::initializer_list<std::span<std::byte const>> sps ) {
+			return write_vectored(
+			  s,
+			  std::span<std::span<std::byte const> const>( sps.begin( ), sps.size( ) ) );
+		}
+
+		[[nodiscard]] static constexpr IOOpResult
+		write_vectored( value_type &s,
+		                std::span<std::span<std::byte const> const> sps ) {
 			auto const total_sz =
 			  std::accumulate( sps.begin( ), sps.end( ), std::size_t{ 0 },
-			                   []( std::size_t sz, daw::string_view sv ) {
-				                   return sz + sv.size( );
+			                   []( std::size_t sz, std::span<std::byte const> sp ) {
+				                   return sz + sp.size( );
 			                   } );
 			if( s.size( ) < total_sz ) {
 				return { IOOpStatus::Eof, 0 };
@@ -85,6 +101,27 @@ namespace daw::io {
 			return { IOOpStatus::Ok, total_sz };
 		}
 
+		[[nodiscard]] static constexpr std::span<char> prepare( value_type &s,
+		                                                        std::size_t n ) {
+			if( s.size( ) < n ) {
+				return { };
+			}
+			if constexpr( std::is_same_v<CharT, char> ) {
+				return s.first( n );
+			} else {
+				return std::span<char>( reinterpret_cast<char *>( s.data( ) ), n );
+			}
+		}
+
+		static constexpr IOOpResult commit( value_type &s,
+		                                    std::span<char> prepared,
+		                                    std::size_t count ) {
+			assert( count <= prepared.size( ) );
+			(void)prepared;
+			s = s.subspan( count );
+			return { IOOpStatus::Ok, count };
+		}
+
 		[[nodiscard]] static constexpr IOOpResult put( value_type &writer,
 		                                               char c ) {
 			if( writer.empty( ) ) {
@@ -10,12 +10,23 @@
 
 #include "daw/io/daw_write_proxy.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
 #include <ostream>
+#include <span>
 #include <utility>
 
 namespace daw::io {
+	/// @brief A std::streambuf writing to a WriteProxy.  Output is collected in
+	/// a put area and written when it is full, on sync( ) (e.g. std::flush or
+	/// std::endl) and on destruction, so that small insertions do not each
+	/// become a write.  Flush before writing to writer( ) directly to keep the
+	/// output in order
 	class write_streambuf : public std::basic_streambuf<char> {
 		WriteProxy m_writer;
+		std::unique_ptr<char[]> m_owned_buffer;
 
 		template<typename WritableType>
 		static constexpr bool is_writable_type =
@@ -23,39 +34,128 @@ namespace daw::io {
 		  not std::is_same_v<WriteProxy, WritableType> and
 		  not std::is_const_v<WritableType>;
 
+		void set_buffer( std::span<char> buffer ) {
+			setp( buffer.data( ), buffer.data( ) + buffer.size( ) );
+		}
+
+		void own_buffer( std::size_t buffer_size ) {
+			if( buffer_size > 0 ) {
+				m_owned_buffer = std::make_unique_for_overwrite<char[]>( buffer_size );
+				set_buffer( std::span<char>( m_owned_buffer.get( ), buffer_size ) );
+			}
+		}
+
+		/// @brief Write the put area to the WriteProxy.  On error, the unwritten
+		/// data remains in the put area
+		/// @return true when all of it was written
+		bool flush_buffer( ) {
+			auto const sz = static_cast<std::size_t>( pptr( ) - pbase( ) );
+			if( sz == 0 ) {
+				return true;
+			}
+			auto const ret = m_writer.write( daw::string_view( pbase( ), sz ) );
+			auto const written = std::min( ret.count, sz );
+			std::memmove( pbase( ), pbase( ) + written, sz - written );
+			setp( pbase( ), epptr( ) );
+			pbump( static_cast<int>( sz - written ) );
+			return ret.status == IOOpStatus::Ok and written == sz;
+		}
+
 	public:
+		static constexpr std::size_t default_buffer_size = 4096U;
+
+		/// @param buffer_size The size of the owned put area, 0 writes each
+		/// insertion through immediately
 		template<typename WritableType,
 		         std::enable_if_t<is_writable_type<WritableType>, std::nullptr_t> =
 		           nullptr>
-		explicit inline write_streambuf( WritableType &writer )
-		  : m_writer( writer ) {}
+		explicit inline write_streambuf(
+		  WritableType &writer, std::size_t buffer_size = default_buffer_size )
+		  : m_writer( writer ) {
+			own_buffer( buffer_size );
+		}
 
-		explicit inline write_streambuf( WriteProxy const &writer )
-		  : m_writer( writer ) {}
+		explicit inline write_streambuf(
+		  WriteProxy const &writer, std::size_t buffer_size = default_buffer_size )
+		  : m_writer( writer ) {
+			own_buffer( buffer_size );
+		}
+
+		explicit inline write_streambuf(
+		  WriteProxy &&writer, std::size_t buffer_size = default_buffer_size )
+		  : m_writer( std::move( writer ) ) {
+			own_buffer( buffer_size );
+		}
+
+		/// @param buffer The put area, it must outlive the write_streambuf
+		inline write_streambuf( WriteProxy const &writer, std::span<char> buffer )
+		  : m_writer( writer ) {
+			set_buffer( buffer );
+		}
 
-		explicit inline write_streambuf( WriteProxy &&writer )
-		  : m_writer( std::move( writer ) ) {}
+		inline write_streambuf( WriteProxy &&writer, std::span<char> buffer )
+		  : m_writer( std::move( writer ) ) {
+			set_buffer( buffer );
+		}
+
+		write_streambuf( write_streambuf const & ) = delete;
+		write_streambuf &operator=( write_streambuf const & ) = delete;
+
+		/// The put area is written on destruction, errors are discarded.  Call
+		/// pubsync( ) first when the result matters
+		~write_streambuf( ) override {
+			(void)flush_buffer( );
+		}
 
 		inline int overflow( int_type c = traits_type::eof( ) ) override {
-			if( not traits_type::eq_int_type( c, traits_type::eof( ) ) ) {
-				auto ret = m_writer.put( static_cast<char>( c ) );
-				if( ret.status != IOOpStatus::Ok ) {
-					return traits_type::eof( );
-				}
+			if( not flush_buffer( ) ) {
+				return traits_type::eof( );
 			}
-			return traits_type::not_eof( c );
+			if( traits_type::eq_int_type( c, traits_type::eof( ) ) ) {
+				return traits_type::not_eof( c );
+			}
+			if( pptr( ) != epptr( ) ) {
+				*pptr( ) = traits_type::to_char_type( c );
+				pbump( 1 );
+				return c;
+			}
+			auto ret = m_writer.put( traits_type::to_char_type( c ) );
+			if( ret.status != IOOpStatus::Ok ) {
+				return traits_type::eof( );
+			}
+			return c;
 		}
 
 		inline std::streamsize xsputn( char_type const *str,
 		                               std::streamsize n ) override {
-			auto ret = m_writer.write(
-			  daw::string_view( str, static_cast<std::size_t>( n ) ) );
+			if( n <= 0 ) {
+				return 0;
+			}
+			auto const sz = static_cast<std::size_t>( n );
+			if( sz <= static_cast<std::size_t>( epptr( ) - pptr( ) ) ) {
+				std::memcpy( pptr( ), str, sz );
+				pbump( static_cast<int>( n ) );
+				return n;
+			}
+			if( not flush_buffer( ) ) {
+				return traits_type::eof( );
+			}
+			if( sz < static_cast<std::size_t>( epptr( ) - pbase( ) ) ) {
+				std::memcpy( pptr( ), str, sz );
+				pbump( static_cast<int>( n ) );
+				return n;
+			}
+			auto ret = m_writer.write( daw::string_view( str, sz ) );
 			if( ret.status != IOOpStatus::Ok ) {
 				return traits_type::eof( );
 			}
 			return static_cast<std::streamsize>( ret.count );
 		}
 
+		inline int sync( ) override {
+			return flush_buffer( ) ? 0 : -1;
+		}
+
 		WriteProxy const &writer( ) const {
 			return m_writer;
 		}
@@ -78,21 +178,40 @@ namespace daw::io {
 		template<typename WritableType,
 		         std::enable_if_t<is_writable_type<WritableType>, std::nullptr_t> =
 		           nullptr>
-		explicit inline write_ostream( WritableType &writer )
+		explicit inline write_ostream(
+		  WritableType &writer,
+		  std::size_t buffer_size = write_streambuf::default_buffer_size )
+		  : std::ostream( nullptr )
+		  , m_stream( writer, buffer_size ) {
+			rdbuf( std::addressof( m_stream ) );
+		}
+
+		explicit inline write_ostream(
+		  WriteProxy const &writer,
+		  std::size_t buffer_size = write_streambuf::default_buffer_size )
+		  : std::ostream( nullptr )
+		  , m_stream( writer, buffer_size ) {
+			rdbuf( std::addressof( m_stream ) );
+		}
+
+		explicit inline write_ostream(
+		  WriteProxy &&writer,
+		  std::size_t buffer_size = write_streambuf::default_buffer_size )
 		  : std::ostream( nullptr )
-		  , m_stream( writer ) {
+		  , m_stream( writer, buffer_size ) {
 			rdbuf( std::addressof( m_stream ) );
 		}
 
-		explicit inline write_ostream( WriteProxy const &writer )
+		/// @param buffer The put area, it must outlive the write_ostream
+		inline write_ostream( WriteProxy const &writer, std::span<char> buffer )
 		  : std::ostream( nullptr )
-		  , m_stream( writer ) {
+		  , m_stream( writer, buffer ) {
 			rdbuf( std::addressof( m_stream ) );
 		}
 
-		explicit inline write_ostream( WriteProxy &&writer )
+		inline write_ostream( WriteProxy &&writer, std::span<char> buffer )
 		  : std::ostream( nullptr )
-		  , m_stream( writer ) {
+		  , m_stream( writer, buffer ) {
 			rdbuf( std::addressof( m_stream ) );
 		}
 
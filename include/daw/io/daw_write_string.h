@@ -15,12 +15,14 @@
 #include <daw/daw_string_view.h>
 
 #include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <initializer_list>
 #include <numeric>
 #include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace daw::io {
 	template<typename CharT, typename Allocator>
@@ -33,7 +35,7 @@ namespace daw::io {
 				s.append( static_cast<std::string_view>( sv ) );
 			} else {
 				auto const idx_first = s.size( );
-				s.resize( s.size( ) + idx_first );
+				s.resize( idx_first + sv.size( ) );
 				(void)io_details::write_to_buffer( s.data( ) + idx_first, sv );
 			}
 			return { IOOpStatus::Ok, sv.size( ) };
@@ -41,6 +43,12 @@ namespace daw::io {
 
 		static DAW_CPP20_CX_ALLOC IOOpResult
 		write( value_type &s, std::initializer_list<daw::string_view> svs ) {
+			return write_vectored(
+			  s, std::span<daw::string_view const>( svs.begin( ), svs.size( ) ) );
+		}
+
+		static DAW_CPP20_CX_ALLOC IOOpResult
+		write_vectored( value_type &s, std::span<daw::string_view const> svs ) {
 			auto const idx_first = s.size( );
 			auto const total_to_add =
 			  std::accumulate( svs.begin( ), svs.end( ), std::size_t{ 0 },
@@ -60,7 +68,7 @@ namespace daw::io {
 		static DAW_CPP20_CX_ALLOC IOOpResult
 		write( value_type &s, std::span<std::byte const> sp ) {
 			auto const idx_first = s.size( );
-			s.resize( s.size( ) + idx_first );
+			s.resize( idx_first + sp.size( ) );
 			(void)io_details::write_to_buffer(
 			  std::next( s.data( ), static_cast<std::ptrdiff_t>( idx_first ) ), sp );
 			return { IOOpStatus::Ok, sp.size( ) };
@@ -68,6 +76,13 @@ namespace daw::io {
 
 		static DAW_CPP20_CX_ALLOC IOOpResult write(
 		  value_type &s, std::initializer_list<std::span<std::byte const>> sps ) {
+			return write_vectored(
+			  s,
+			  std::span<std::span<std::byte const> const>( sps.begin( ), sps.size( ) ) );
+		}
+
+		static DAW_CPP20_CX_ALLOC IOOpResult write_vectored(
+		  value_type &s, std::span<std::span<std::byte const> const> sps ) {
 			auto const idx_first = s.size( );
 			auto const total_to_add =
 			  std::accumulate( sps.begin( ), sps.end( ), std::size_t{ 0 },
@@ -84,6 +99,35 @@ namespace daw::io {
 			return { IOOpStatus::Ok, total_to_add };
 		}
 
+		static DAW_CPP20_CX_ALLOC std::span<char> prepare( value_type &s,
+		                                                    std::size_t n )
+		  requires( std::is_same_v<CharT, char> ) {
+			auto const idx_first = s.size( );
+			s.resize( idx_first + n );
+			return std::span<char>(
+			  std::next( s.data( ), static_cast<std::ptrdiff_t>( idx_first ) ), n );
+		}
+
+		static DAW_CPP20_CX_ALLOC IOOpResult commit( value_type &s,
+		                                             std::span<char> prepared,
+		                                             std::size_t count )
+		  requires( std::is_same_v<CharT, char> ) {
+			assert( count <= prepared.size( ) );
+			auto const idx_first =
+			  static_cast<std::size_t>( prepared.data( ) - s.data( ) );
+			s.resize( idx_first + count );
+			return { IOOpStatus::Ok, count };
+		}
+
+		/// @brief Make room for n more characters.  Capacity at least doubles
+		/// when it grows, so repeated reserves stay amortized O(1)
+		static DAW_CPP20_CX_ALLOC void reserve( value_type &s, std::size_t n ) {
+			auto const needed = s.size( ) + n;
+			if( needed > s.capacity( ) ) {
+				s.reserve( std::max( needed, s.capacity( ) * 2U ) );
+			}
+		}
+
 		static DAW_CPP20_CX_ALLOC IOOpResult put( value_type &writer, char c ) {
 			writer += static_cast<CharT>( c );
 			return { IOOpStatus::Ok, 1 };
@@ -0,0 +1,334 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_fd_wrap.h"
+#include "daw_io_uring.h"
+#include "daw_write_base.h"
+#include "daw_write_fd.h"
+
+#include <daw/daw_string_view.h>
+#include <daw/daw_traits.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace daw::io {
+	/// @brief Write to a file descriptor through io_uring.  Writes are copied
+	/// into one of queue_depth buffers and return once queued, a full buffer is
+	/// submitted without waiting for it.  The caller only blocks when every
+	/// buffer is in flight, or in flush( ), which submits the partial buffer
+	/// and reaps all completions.  Regular files get a write per buffer at
+	/// increasing offsets, all in flight at once.  Pipes, sockets and O_APPEND
+	/// files have one write in flight at a time to keep the order.  When
+	/// io_uring is unavailable writes go directly to the fd as with fd_wrap_t.
+	/// The fd remains owned by the caller and must outlive the uring_writer
+	class uring_writer {
+		struct buffer_state {
+			std::size_t size = 0;
+			std::int64_t offset = -1;
+			bool in_flight = false;
+		};
+
+		int m_fd;
+		io_details::uring_buffers m_memory;
+		std::vector<buffer_state> m_buffers;
+		// After m_memory so that the ring, and its requests, go first
+		io_details::uring m_ring;
+		// The file offset of the next buffer submitted, or -1 to write at the
+		// file position
+		std::int64_t m_offset = -1;
+		std::size_t m_max_in_flight = 1;
+		std::size_t m_in_flight = 0;
+		std::size_t m_current = 0;
+		std::size_t m_completed = 0;
+		IOOpStatus m_status = IOOpStatus::Ok;
+
+		/// @brief Write the rest of a buffer the kernel only partially wrote
+		[[nodiscard]] bool finish_write( buffer_state const &b, char const *data,
+		                                 std::size_t done ) {
+			while( done < b.size ) {
+				auto const result =
+				  b.offset >= 0
+				    ? ::pwrite( m_fd, data + done, b.size - done,
+				                static_cast<::off_t>( b.offset ) +
+				                  static_cast<::off_t>( done ) )
+				    : ::write( m_fd, data + done, b.size - done );
+				if( result <= 0 ) {
+					return false;
+				}
+				done += static_cast<std::size_t>( result );
+			}
+			return true;
+		}
+
+		void queue_write( std::size_t idx ) {
+			m_ring.queue_rw( static_cast<std::uint8_t>( m_memory.is_fixed( )
+			                                              ? IORING_OP_WRITE_FIXED
+			                                              : IORING_OP_WRITE ),
+			                 m_fd, m_memory.data( idx ), m_buffers[idx].size,
+			                 m_buffers[idx].offset, m_memory.fixed_index( idx ), idx );
+		}
+
+		void complete( io_details::uring_completion const &cqe ) {
+			auto const idx = static_cast<std::size_t>( cqe.user_data );
+			buffer_state &b = m_buffers[idx];
+			assert( b.in_flight );
+			if( cqe.res == -EINTR or cqe.res == -EAGAIN ) {
+				queue_write( idx );
+				return;
+			}
+			if( cqe.res < 0 or
+			    not finish_write( b, m_memory.data( idx ),
+			                      static_cast<std::size_t>( cqe.res ) ) ) {
+				m_status = IOOpStatus::Error;
+			} else {
+				m_completed += b.size;
+			}
+			b = buffer_state{ };
+			--m_in_flight;
+		}
+
+		/// @brief Wait for at least one completion and process all available
+		[[nodiscard]] bool wait_one( ) {
+			if( not m_ring.submit( 1 ) ) {
+				m_status = IOOpStatus::Error;
+				return false;
+			}
+			while( auto const cqe = m_ring.pop_completion( ) ) {
+				complete( *cqe );
+			}
+			return true;
+		}
+
+		/// @brief Submit the buffer being filled and move to the next one,
+		/// waiting for it to be written if it is still in flight
+		[[nodiscard]] bool submit_current( ) {
+			buffer_state &b = m_buffers[m_current];
+			if( b.size == 0 ) {
+				return m_status == IOOpStatus::Ok;
+			}
+			while( m_in_flight >= m_max_in_flight ) {
+				if( not wait_one( ) ) {
+					return false;
+				}
+			}
+			b.offset = m_offset;
+			if( m_offset >= 0 ) {
+				m_offset += static_cast<std::int64_t>( b.size );
+			}
+			queue_write( m_current );
+			if( not m_ring.submit( ) ) {
+				m_status = IOOpStatus::Error;
+				return false;
+			}
+			b.in_flight = true;
+			++m_in_flight;
+			m_current = ( m_current + 1 ) % m_buffers.size( );
+			while( m_buffers[m_current].in_flight ) {
+				if( not wait_one( ) ) {
+					return false;
+				}
+			}
+			return m_status == IOOpStatus::Ok;
+		}
+
+		template<typename ContiguousRange>
+		[[nodiscard]] IOOpResult write_impl( ContiguousRange const &r ) {
+			if( not m_ring.is_open( ) ) {
+				return WritableOutput<fd_wrap_t>::write( fd_wrap_t( m_fd ), r );
+			}
+			if( m_status != IOOpStatus::Ok ) {
+				return { m_status, 0 };
+			}
+			auto const *first =
+			  static_cast<char const *>( static_cast<void const *>( std::data( r ) ) );
+			auto const total = std::size( r );
+			std::size_t written = 0;
+			while( written < total ) {
+				buffer_state &b = m_buffers[m_current];
+				auto const n =
+				  std::min( total - written, m_memory.buffer_size( ) - b.size );
+				std::memcpy( m_memory.data( m_current ) + b.size, first + written, n );
+				b.size += n;
+				written += n;
+				if( b.size == m_memory.buffer_size( ) and not submit_current( ) ) {
+					return { IOOpStatus::Error, written };
+				}
+			}
+			return { IOOpStatus::Ok, written };
+		}
+
+	public:
+		explicit uring_writer( fd_wrap_t fd, uring_options opts = uring_options{ } )
+		  : m_fd( fd.value )
+		  , m_memory( opts )
+		  , m_buffers( m_memory.count( ) )
+		  , m_ring( static_cast<unsigned>( m_memory.count( ) ) ) {
+			if( not m_ring.is_open( ) ) {
+				return;
+			}
+			if( opts.register_buffers ) {
+				(void)m_memory.register_with( m_ring );
+			}
+			auto const pos = ::lseek( m_fd, 0, SEEK_CUR );
+			int const flags = ::fcntl( m_fd, F_GETFL );
+			if( pos >= 0 and flags >= 0 and ( flags & O_APPEND ) == 0 ) {
+				m_offset = static_cast<std::int64_t>( pos );
+				m_max_in_flight = m_buffers.size( );
+			}
+		}
+
+		uring_writer( uring_writer const & ) = delete;
+		uring_writer &operator=( uring_writer const & ) = delete;
+
+		/// The data is flushed on destruction, errors are discarded.  Call
+		/// flush( ) first when the result matters
+		~uring_writer( ) {
+			(void)flush( );
+		}
+
+		/// @return true when writes go through io_uring, false when they use the
+		/// fd directly
+		[[nodiscard]] bool is_async( ) const {
+			return m_ring.is_open( );
+		}
+
+		/// @brief Submit the partially filled buffer and wait for every write in
+		/// flight to complete.  Afterwards the file position of a regular file is
+		/// after the last byte written
+		/// @return The bytes completed since the last flush.  Once a write has
+		/// failed the status is Error
+		IOOpResult flush( ) {
+			if( not m_ring.is_open( ) ) {
+				return { IOOpStatus::Ok, 0 };
+			}
+			(void)submit_current( );
+			while( m_in_flight > 0 ) {
+				if( not wait_one( ) ) {
+					break;
+				}
+			}
+			if( m_offset >= 0 ) {
+				::lseek( m_fd, static_cast<::off_t>( m_offset ), SEEK_SET );
+			}
+			return { m_status, std::exchange( m_completed, 0 ) };
+		}
+
+		[[nodiscard]] IOOpResult write( daw::string_view sv ) {
+			return write_impl( sv );
+		}
+
+		[[nodiscard]] IOOpResult write( std::span<std::byte const> sp ) {
+			return write_impl( sp );
+		}
+
+		/// @brief Acquire n bytes of the current buffer to write into directly
+		/// @return The memory, or an empty span when n is larger than a buffer or
+		/// io_uring is unavailable
+		[[nodiscard]] std::span<char> prepare( std::size_t n ) {
+			if( not m_ring.is_open( ) or n > m_memory.buffer_size( ) or
+			    m_status != IOOpStatus::Ok ) {
+				return { };
+			}
+			if( m_memory.buffer_size( ) - m_buffers[m_current].size < n and
+			    not submit_current( ) ) {
+				return { };
+			}
+			return std::span<char>(
+			  m_memory.data( m_current ) + m_buffers[m_current].size, n );
+		}
+
+		IOOpResult commit( std::span<char> prepared, std::size_t count ) {
+			buffer_state &b = m_buffers[m_current];
+			assert( prepared.data( ) == m_memory.data( m_current ) + b.size );
+			assert( count <= prepared.size( ) );
+			(void)prepared;
+			b.size += count;
+			if( b.size == m_memory.buffer_size( ) and not submit_current( ) ) {
+				return { IOOpStatus::Error, count };
+			}
+			return { IOOpStatus::Ok, count };
+		}
+
+		template<typename Byte>
+		[[nodiscard]] IOOpResult put( Byte b ) {
+			static_assert( daw::traits::is_one_of_v<Byte, char, std::byte> );
+			auto const c = static_cast<char>( b );
+			return write_impl( daw::string_view( &c, 1 ) );
+		}
+	};
+
+	template<>
+	struct WritableOutput<uring_writer> {
+		[[nodiscard]] static inline IOOpResult write( uring_writer &uw,
+		                                              daw::string_view sv ) {
+			return uw.write( sv );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( uring_writer &uw, std::initializer_list<daw::string_view> svs ) {
+			std::size_t written = 0;
+			for( daw::string_view sv : svs ) {
+				auto const r = uw.write( sv );
+				written += r.count;
+				if( r.status != IOOpStatus::Ok ) {
+					return { r.status, written };
+				}
+			}
+			return { IOOpStatus::Ok, written };
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( uring_writer &uw, std::span<std::byte const> sp ) {
+			return uw.write( sp );
+		}
+
+		[[nodiscard]] static inline IOOpResult
+		write( uring_writer &uw,
+		       std::initializer_list<std::span<std::byte const>> sps ) {
+			std::size_t written = 0;
+			for( std::span<std::byte const> sp : sps ) {
+				auto const r = uw.write( sp );
+				written += r.count;
+				if( r.status != IOOpStatus::Ok ) {
+					return { r.status, written };
+				}
+			}
+			return { IOOpStatus::Ok, written };
+		}
+
+		[[nodiscard]] static inline std::span<char> prepare( uring_writer &uw,
+		                                                     std::size_t n ) {
+			return uw.prepare( n );
+		}
+
+		static inline IOOpResult commit( uring_writer &uw,
+		                                 std::span<char> prepared,
+		                                 std::size_t count ) {
+			return uw.commit( prepared, count );
+		}
+
+		template<typename Byte>
+		[[nodiscard]] static inline IOOpResult put( uring_writer &uw, Byte b ) {
+			return uw.put( b );
+		}
+	};
+} // namespace daw::io
@@ -0,0 +1,163 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw/io/daw_read_write.h"
+
+#include <daw/daw_string_view.h>
+
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+namespace daw::io::type_writer {
+	/// @brief A float or double with how to format it.  A negative precision
+	/// is the shortest representation in format that round trips
+	template<typename Float>
+	struct formatted_float {
+		Float value;
+		std::chars_format format = std::chars_format::general;
+		int precision = -1;
+	};
+
+	/// @brief Format value as ddd.ddd with precision digits after the point
+	template<typename Float>
+	[[nodiscard]] constexpr formatted_float<Float> fixed( Float value,
+	                                                      int precision = -1 ) {
+		return { value, std::chars_format::fixed, precision };
+	}
+
+	/// @brief Format value as d.ddde±dd with precision digits after the point
+	template<typename Float>
+	[[nodiscard]] constexpr formatted_float<Float>
+	scientific( Float value, int precision = -1 ) {
+		return { value, std::chars_format::scientific, precision };
+	}
+
+	/// @brief Format value as fixed or scientific, as printf's %g does, with
+	/// precision significant digits
+	template<typename Float>
+	[[nodiscard]] constexpr formatted_float<Float> general( Float value,
+	                                                        int precision = -1 ) {
+		return { value, std::chars_format::general, precision };
+	}
+
+	namespace impl {
+		template<typename T>
+		inline constexpr bool is_float_writable_v =
+		  std::is_same_v<T, float> or std::is_same_v<T, double>;
+
+		/// The most characters the shortest representation of a Float formats
+		/// to, e.g. -2.2250738585072014e-308
+		template<typename Float>
+		inline constexpr std::size_t max_shortest_chars =
+		  static_cast<std::size_t>( std::numeric_limits<Float>::max_digits10 ) +
+		  8U;
+
+		/// @brief An upper bound of the characters value formats to with
+		/// format and precision
+		template<typename Float>
+		[[nodiscard]] constexpr std::size_t
+		max_formatted_chars( formatted_float<Float> const &value ) {
+			using limits = std::numeric_limits<Float>;
+			auto const digits =
+			  value.precision < 0
+			    ? static_cast<std::size_t>( limits::max_digits10 )
+			    : static_cast<std::size_t>( value.precision );
+			if( value.format != std::chars_format::fixed ) {
+				// Sign, point, exponent and up to 4 leading zeros of %g
+				return digits + 12U;
+			}
+			auto const integer_digits =
+			  static_cast<std::size_t>( limits::max_exponent10 ) + 1U;
+			// Denormals need up to max_digits10 past min_exponent10
+			auto const fraction_digits =
+			  value.precision < 0
+			    ? digits + static_cast<std::size_t>( -limits::min_exponent10 )
+			    : digits;
+			return integer_digits + fraction_digits + 2U;
+		}
+
+		template<typename Float>
+		[[nodiscard]] std::size_t to_chars( std::span<char> buff,
+		                                    formatted_float<Float> const &value ) {
+			char *const first = buff.data( );
+			char *const last = first + buff.size( );
+			auto const result =
+			  value.precision < 0
+			    ? std::to_chars( first, last, value.value, value.format )
+			    : std::to_chars( first, last, value.value, value.format,
+			                     value.precision );
+			assert( result.ec == std::errc{ } );
+			return static_cast<std::size_t>( result.ptr - first );
+		}
+	} // namespace impl
+
+	/// @brief An upper bound of the characters type_writer writes for f.
+	/// The exact count needs f to be formatted
+	template<typename Float,
+	         std::enable_if_t<impl::is_float_writable_v<Float>, std::nullptr_t> =
+	           nullptr>
+	[[nodiscard]] constexpr std::size_t type_writer_size( Float const & ) {
+		return impl::max_shortest_chars<Float>;
+	}
+
+	template<typename Float,
+	         std::enable_if_t<impl::is_float_writable_v<Float>, std::nullptr_t> =
+	           nullptr>
+	[[nodiscard]] constexpr std::size_t
+	type_writer_size( formatted_float<Float> const &f ) {
+		return impl::max_formatted_chars( f );
+	}
+
+	/// @brief Write the shortest representation of f that reads back as the
+	/// same value
+	template<typename Float, typename Writer,
+	         std::enable_if_t<impl::is_float_writable_v<Float>, std::nullptr_t> =
+	           nullptr>
+	daw::io::IOOpResult type_writer( Writer &writer, Float const &f ) {
+		return daw::io::write_direct<impl::max_shortest_chars<Float>>(
+		  writer, [&]( std::span<char> buff ) -> std::size_t {
+			  char *const first = buff.data( );
+			  auto const result = std::to_chars( first, first + buff.size( ), f );
+			  assert( result.ec == std::errc{ } );
+			  return static_cast<std::size_t>( result.ptr - first );
+		  } );
+	}
+
+	/// @brief Write f in its format and precision, see fixed, scientific and
+	/// general
+	template<typename Float, typename Writer,
+	         std::enable_if_t<impl::is_float_writable_v<Float>, std::nullptr_t> =
+	           nullptr>
+	daw::io::IOOpResult type_writer( Writer &writer,
+	                                 formatted_float<Float> const &f ) {
+		// Most values fit the small buffer, the largest fixed values or large
+		// precisions need more
+		constexpr std::size_t small_size = 64U;
+		constexpr std::size_t large_size = 1024U;
+		auto const max_size = impl::max_formatted_chars( f );
+		auto const op = [&]( std::span<char> buff ) -> std::size_t {
+			return impl::to_chars( buff, f );
+		};
+		if( max_size <= small_size ) {
+			return daw::io::write_direct<small_size>( writer, op );
+		} else if( max_size <= large_size ) {
+			return daw::io::write_direct<large_size>( writer, op );
+		}
+		auto buff = std::make_unique_for_overwrite<char[]>( max_size );
+		auto const count = op( std::span<char>( buff.get( ), max_size ) );
+		return writer.write( daw::string_view( buff.get( ), count ) );
+	}
+} // namespace daw::io::type_writer
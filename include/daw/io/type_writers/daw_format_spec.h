@@ -0,0 +1,504 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw/io/daw_read_write.h"
+#include "daw_float_writer.h"
+#include "daw_integer_writer.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace daw::io::type_writer {
+	struct invalid_format_spec_exception {
+		explicit invalid_format_spec_exception( ) = default;
+	};
+
+	/// @brief The parsed form of a std::format style replacement field spec,
+	/// [[fill]align][sign][#][0][width][.precision][type]
+	struct format_spec {
+		char fill = ' ';
+		/// '<', '>', '^' or 0 for the default of the argument's type
+		char align = 0;
+		/// '-', '+' or ' '
+		char sign = '-';
+		bool alternate = false;
+		bool zero_pad = false;
+		std::size_t width = 0;
+		int precision = -1;
+		/// The presentation type or 0 for the default of the argument's type
+		char type = 0;
+
+		[[nodiscard]] constexpr bool is_default( ) const {
+			return fill == ' ' and align == 0 and sign == '-' and not alternate and
+			       not zero_pad and width == 0 and precision < 0 and type == 0;
+		}
+	};
+
+	namespace impl {
+		/// What format specs an argument accepts
+		enum class arg_kind { integer, character, floating, string, other };
+
+		template<typename T>
+		[[nodiscard]] consteval arg_kind arg_kind_of( ) {
+			using type = std::remove_cvref_t<T>;
+			if constexpr( std::is_constructible_v<daw::string_view, type const &> ) {
+				return arg_kind::string;
+			} else if constexpr( std::is_same_v<type, char> ) {
+				return arg_kind::character;
+			} else if constexpr( daw::is_integral_v<type> ) {
+				return arg_kind::integer;
+			} else if constexpr( is_float_writable_v<type> ) {
+				return arg_kind::floating;
+			} else {
+				return arg_kind::other;
+			}
+		}
+
+		[[nodiscard]] constexpr bool is_one_of( char c, daw::string_view chars ) {
+			for( char o : chars ) {
+				if( c == o ) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		[[nodiscard]] constexpr bool is_digit( char c ) {
+			return c >= '0' and c <= '9';
+		}
+
+		/// @brief Check that spec is meaningful for an argument of kind
+		consteval void validate_format_spec( format_spec const &spec,
+		                                     arg_kind kind ) {
+			auto const fail = [] {
+				throw invalid_format_spec_exception{ };
+			};
+			bool const numeric_flags =
+			  spec.sign != '-' or spec.alternate or spec.zero_pad;
+			switch( kind ) {
+			case arg_kind::other:
+				if( not spec.is_default( ) ) {
+					fail( );
+				}
+				return;
+			case arg_kind::string:
+				if( numeric_flags or ( spec.type != 0 and spec.type != 's' ) ) {
+					fail( );
+				}
+				return;
+			case arg_kind::character:
+				if( spec.type == 0 or spec.type == 'c' ) {
+					if( numeric_flags or spec.precision >= 0 ) {
+						fail( );
+					}
+					return;
+				}
+				[[fallthrough]];
+			case arg_kind::integer:
+				if( spec.precision >= 0 or
+				    ( spec.type != 0 and not is_one_of( spec.type, "dbBoxXc" ) ) or
+				    ( spec.type == 'c' and numeric_flags ) ) {
+					fail( );
+				}
+				return;
+			case arg_kind::floating:
+				if( spec.alternate or
+				    ( spec.type != 0 and not is_one_of( spec.type, "fFeEgG" ) ) ) {
+					fail( );
+				}
+				return;
+			}
+		}
+
+		/// @brief Parse the part of a replacement field after the ':'
+		/// @throws invalid_format_spec_exception, as a compile error, when spec
+		/// is malformed or not valid for kind
+		[[nodiscard]] consteval format_spec
+		parse_format_spec( daw::string_view spec_str, arg_kind kind ) {
+			auto result = format_spec{ };
+			char const *ptr = spec_str.data( );
+			char const *const last = spec_str.data_end( );
+			auto const has = [&]( std::size_t n ) {
+				return static_cast<std::size_t>( last - ptr ) >= n;
+			};
+			if( has( 2 ) and is_one_of( ptr[1], "<>^" ) ) {
+				if( ptr[0] == '{' or ptr[0] == '}' ) {
+					throw invalid_format_spec_exception{ };
+				}
+				result.fill = ptr[0];
+				result.align = ptr[1];
+				ptr += 2;
+			} else if( has( 1 ) and is_one_of( ptr[0], "<>^" ) ) {
+				result.align = *ptr++;
+			}
+			if( has( 1 ) and is_one_of( ptr[0], "+- " ) ) {
+				result.sign = *ptr++;
+			}
+			if( has( 1 ) and ptr[0] == '#' ) {
+				result.alternate = true;
+				++ptr;
+			}
+			if( has( 1 ) and ptr[0] == '0' ) {
+				result.zero_pad = true;
+				++ptr;
+			}
+			while( has( 1 ) and is_digit( ptr[0] ) ) {
+				result.width =
+				  result.width * 10U + static_cast<std::size_t>( *ptr++ - '0' );
+			}
+			if( has( 1 ) and ptr[0] == '.' ) {
+				++ptr;
+				if( not has( 1 ) or not is_digit( ptr[0] ) ) {
+					throw invalid_format_spec_exception{ };
+				}
+				result.precision = 0;
+				while( has( 1 ) and is_digit( ptr[0] ) ) {
+					result.precision = result.precision * 10 + ( *ptr++ - '0' );
+				}
+			}
+			if( has( 1 ) ) {
+				result.type = *ptr++;
+			}
+			if( ptr != last ) {
+				throw invalid_format_spec_exception{ };
+			}
+			validate_format_spec( result, kind );
+			return result;
+		}
+
+		/// Fields up to this size are composed on the stack, or in place for
+		/// sinks that can prepare, and written at once
+		inline constexpr std::size_t max_direct_field_size = 256U;
+
+		template<typename Writer>
+		[[nodiscard]] IOOpResult write_fill( Writer &writer, char fill,
+		                                     std::size_t count ) {
+			char buff[64];
+			std::memset( buff, fill, sizeof( buff ) );
+			auto result = IOOpResult{ };
+			while( count > 0 and result.status == IOOpStatus::Ok ) {
+				auto const sz = std::min( count, sizeof( buff ) );
+				auto const r = writer.write( daw::string_view( buff, sz ) );
+				result.status = r.status;
+				result.count += r.count;
+				count -= sz;
+			}
+			return result;
+		}
+
+		/// @brief Write prefix and body padded to spec.width.  Zero padding goes
+		/// between the prefix, a sign or base prefix, and the body
+		template<typename Writer>
+		[[nodiscard]] IOOpResult
+		write_padded( Writer &writer, format_spec const &spec, char default_align,
+		              daw::string_view prefix, daw::string_view body,
+		              bool allow_zero_pad = true ) {
+			auto const size = prefix.size( ) + body.size( );
+			auto const padding = spec.width > size ? spec.width - size : 0U;
+			std::size_t left = 0;
+			std::size_t zeros = 0;
+			std::size_t right = 0;
+			if( spec.zero_pad and spec.align == 0 and allow_zero_pad ) {
+				zeros = padding;
+			} else {
+				switch( spec.align == 0 ? default_align : spec.align ) {
+				case '<':
+					right = padding;
+					break;
+				case '^':
+					left = padding / 2U;
+					right = padding - left;
+					break;
+				default:
+					left = padding;
+					break;
+				}
+			}
+			auto const total = size + padding;
+			if( total <= max_direct_field_size ) {
+				return daw::io::write_direct<max_direct_field_size>(
+				  writer, total, [&]( std::span<char> buff ) -> std::size_t {
+					  char *ptr = buff.data( );
+					  std::memset( ptr, spec.fill, left );
+					  ptr += left;
+					  ptr = std::copy( prefix.begin( ), prefix.end( ), ptr );
+					  std::memset( ptr, '0', zeros );
+					  ptr += zeros;
+					  ptr = std::copy( body.begin( ), body.end( ), ptr );
+					  std::memset( ptr, spec.fill, right );
+					  return total;
+				  } );
+			}
+			// Large fields are written in pieces rather than allocating
+			auto result = write_fill( writer, spec.fill, left );
+			auto const accumulate = [&]( IOOpResult const &r ) {
+				result.status = r.status;
+				result.count += r.count;
+			};
+			if( result.status == IOOpStatus::Ok and not prefix.empty( ) ) {
+				accumulate( writer.write( prefix ) );
+			}
+			if( result.status == IOOpStatus::Ok ) {
+				accumulate( write_fill( writer, '0', zeros ) );
+			}
+			if( result.status == IOOpStatus::Ok and not body.empty( ) ) {
+				accumulate( writer.write( body ) );
+			}
+			if( result.status == IOOpStatus::Ok ) {
+				accumulate( write_fill( writer, spec.fill, right ) );
+			}
+			return result;
+		}
+
+		constexpr void to_upper( std::span<char> buff ) {
+			for( char &c : buff ) {
+				if( c >= 'a' and c <= 'z' ) {
+					c = static_cast<char>( c - 'a' + 'A' );
+				}
+			}
+		}
+
+		/// @return The sign to write for a value, or 0 for none
+		[[nodiscard]] constexpr char sign_char( format_spec const &spec,
+		                                        bool is_negative ) {
+			if( is_negative ) {
+				return '-';
+			}
+			return spec.sign == '-' ? '\0' : spec.sign;
+		}
+
+		template<typename Integer>
+		using integer_magnitude_t = std::make_unsigned_t<
+		  std::conditional_t<std::is_same_v<Integer, bool>, unsigned char,
+		                     Integer>>;
+
+		/// @brief An integer split into what is written for it
+		template<typename Integer>
+		struct integer_field {
+			integer_magnitude_t<Integer> magnitude;
+			bool is_negative;
+			int base;
+			/// The alternate form prefix, "" unless spec.alternate
+			char const *base_prefix;
+		};
+
+		template<typename Integer>
+		[[nodiscard]] constexpr integer_field<Integer>
+		make_integer_field( format_spec const &spec, Integer const &value ) {
+			using unsigned_type = integer_magnitude_t<Integer>;
+			auto result = integer_field<Integer>{
+			  static_cast<unsigned_type>( value ), false, 10, "" };
+			if constexpr( std::is_signed_v<Integer> ) {
+				if( value < 0 ) {
+					result.is_negative = true;
+					result.magnitude = static_cast<unsigned_type>( unsigned_type{ 0 } -
+					                                               result.magnitude );
+				}
+			}
+			switch( spec.type ) {
+			case 'b':
+			case 'B':
+				result.base = 2;
+				result.base_prefix = spec.type == 'b' ? "0b" : "0B";
+				break;
+			case 'o':
+				result.base = 8;
+				result.base_prefix = result.magnitude == 0 ? "" : "0";
+				break;
+			case 'x':
+			case 'X':
+				result.base = 16;
+				result.base_prefix = spec.type == 'x' ? "0x" : "0X";
+				break;
+			default:
+				break;
+			}
+			if( not spec.alternate ) {
+				result.base_prefix = "";
+			}
+			return result;
+		}
+
+		/// @brief Whether an integer is written as a character
+		template<typename Integer>
+		[[nodiscard]] constexpr bool
+		is_char_presentation( format_spec const &spec ) {
+			return spec.type == 'c' or
+			       ( spec.type == 0 and std::is_same_v<Integer, char> );
+		}
+
+		template<typename Writer, typename Integer>
+		[[nodiscard]] IOOpResult write_formatted_integer( Writer &writer,
+		                                                  format_spec const &spec,
+		                                                  Integer const &value ) {
+			if( is_char_presentation<Integer>( spec ) ) {
+				auto const c = static_cast<char>( value );
+				return write_padded( writer, spec, '<', { },
+				                     daw::string_view( &c, 1 ) );
+			}
+			using unsigned_type = integer_magnitude_t<Integer>;
+			auto const field = make_integer_field( spec, value );
+			auto const magnitude = field.magnitude;
+			auto const base = field.base;
+			char prefix[3];
+			std::size_t prefix_size = 0;
+			if( char const s = sign_char( spec, field.is_negative ); s != '\0' ) {
+				prefix[prefix_size++] = s;
+			}
+			for( char const *p = field.base_prefix; *p != '\0'; ++p ) {
+				prefix[prefix_size++] = *p;
+			}
+			// Enough for the binary digits of the widest integer
+			char digits[sizeof( unsigned_type ) * 8U];
+			auto const r =
+			  std::to_chars( digits, digits + sizeof( digits ), magnitude, base );
+			auto const digit_count = static_cast<std::size_t>( r.ptr - digits );
+			if( spec.type == 'X' ) {
+				to_upper( std::span<char>( digits, digit_count ) );
+			}
+			return write_padded( writer, spec, '>',
+			                     daw::string_view( prefix, prefix_size ),
+			                     daw::string_view( digits, digit_count ) );
+		}
+
+		template<typename Float>
+		[[nodiscard]] constexpr formatted_float<Float>
+		make_formatted_float( format_spec const &spec, Float const &value ) {
+			// As with printf, a presentation type defaults to 6 digits
+			auto result = formatted_float<Float>{
+			  value, std::chars_format::general,
+			  spec.type != 0 and spec.precision < 0 ? 6 : spec.precision };
+			switch( spec.type ) {
+			case 'f':
+			case 'F':
+				result.format = std::chars_format::fixed;
+				break;
+			case 'e':
+			case 'E':
+				result.format = std::chars_format::scientific;
+				break;
+			default:
+				break;
+			}
+			return result;
+		}
+
+		template<typename Writer, typename Float>
+		[[nodiscard]] IOOpResult write_formatted_float( Writer &writer,
+		                                                format_spec const &spec,
+		                                                Float const &value ) {
+			auto const f = make_formatted_float( spec, value );
+			// As type_writer( formatted_float ), only precisions past what fits the
+			// stack buffer allocate.  Fixed values need up to 309 digits before the
+			// point
+			constexpr std::size_t stack_size = 1024U;
+			auto const max_size = max_formatted_chars( f );
+			char stack_buff[stack_size];
+			auto large_buff = std::unique_ptr<char[]>( );
+			char *buff = stack_buff;
+			if( max_size > stack_size ) {
+				large_buff = std::make_unique_for_overwrite<char[]>( max_size );
+				buff = large_buff.get( );
+			}
+			std::size_t count = 0;
+			if( spec.type == 0 and spec.precision < 0 ) {
+				// The shortest round trip representation, as type_writer
+				count = static_cast<std::size_t>(
+				  std::to_chars( buff, buff + max_size, value ).ptr - buff );
+			} else {
+				count = to_chars( std::span<char>( buff, max_size ), f );
+			}
+			if( is_one_of( spec.type, "FEG" ) ) {
+				to_upper( std::span<char>( buff, count ) );
+			}
+			auto body = daw::string_view( buff, count );
+			bool const is_negative = not body.empty( ) and body.front( ) == '-';
+			if( is_negative ) {
+				body.remove_prefix( 1 );
+			}
+			char const s = sign_char( spec, is_negative );
+			return write_padded( writer, spec, '>',
+			                     daw::string_view( &s, s == '\0' ? 0U : 1U ), body,
+			                     std::isfinite( value ) );
+		}
+
+		/// @brief Write value as described by spec.  spec was validated for
+		/// the type of value when the format string was parsed
+		template<typename Writer, typename T>
+		[[nodiscard]] IOOpResult write_formatted( Writer &writer,
+		                                          format_spec const &spec,
+		                                          T const &value ) {
+			constexpr arg_kind kind = arg_kind_of<T>( );
+			if constexpr( kind == arg_kind::string ) {
+				auto body = daw::string_view( value );
+				if( spec.precision >= 0 ) {
+					body = body.substr(
+					  0, std::min( body.size( ),
+					               static_cast<std::size_t>( spec.precision ) ) );
+				}
+				return write_padded( writer, spec, '<', { }, body );
+			} else if constexpr( kind == arg_kind::character or
+			                     kind == arg_kind::integer ) {
+				return write_formatted_integer( writer, spec, value );
+			} else {
+				static_assert( kind == arg_kind::floating,
+				               "Only the default spec applies to other types" );
+				return write_formatted_float( writer, spec, value );
+			}
+		}
+
+		/// @brief The number of characters write_formatted writes for value,
+		/// an upper bound for floats
+		template<typename T>
+		[[nodiscard]] constexpr std::size_t field_size( format_spec const &spec,
+		                                                T const &value ) {
+			constexpr arg_kind kind = arg_kind_of<T>( );
+			std::size_t size = 0;
+			if constexpr( kind == arg_kind::string ) {
+				size = daw::string_view( value ).size( );
+				if( spec.precision >= 0 ) {
+					size = std::min( size, static_cast<std::size_t>( spec.precision ) );
+				}
+			} else if constexpr( kind == arg_kind::character or
+			                     kind == arg_kind::integer ) {
+				if( is_char_presentation<T>( spec ) ) {
+					size = 1;
+				} else {
+					auto const field = make_integer_field( spec, value );
+					size = daw::string_view( field.base_prefix ).size( ) +
+					       ( sign_char( spec, field.is_negative ) != '\0' ? 1U : 0U );
+					if( field.base == 10 ) {
+						size += digit_count( field.magnitude );
+					} else {
+						auto const base = static_cast<unsigned>( field.base );
+						auto m = field.magnitude;
+						do {
+							++size;
+							m = static_cast<decltype( m )>( m / base );
+						} while( m != 0 );
+					}
+				}
+			} else {
+				static_assert( kind == arg_kind::floating,
+				               "Only the default spec applies to other types" );
+				size = max_formatted_chars( make_formatted_float( spec, value ) );
+			}
+			return std::max( size, spec.width );
+		}
+	} // namespace impl
+} // namespace daw::io::type_writer
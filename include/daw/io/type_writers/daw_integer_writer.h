@@ -13,40 +13,98 @@
 #include <daw/daw_arith_traits.h>
 #include <daw/daw_string_view.h>
 
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <type_traits>
 
 namespace daw::io::type_writer {
 	namespace impl {
-		inline constexpr auto digits100 = [] {
+		/// The two digits of 00 through 99, most significant first
+		inline constexpr auto digit_pairs = [] {
 			std::array<char[2], 100> result{ };
 			for( size_t n = 0; n < 100; ++n ) {
 				result[n][0] =
-				  static_cast<char>( ( n % 10 ) + static_cast<unsigned char>( '0' ) );
-				result[n][1] =
 				  static_cast<char>( ( n / 10 ) + static_cast<unsigned char>( '0' ) );
+				result[n][1] =
+				  static_cast<char>( ( n % 10 ) + static_cast<unsigned char>( '0' ) );
 			}
 			return result;
 		}( );
 
+		/// 10^n for each n a std::uint64_t can hold
+		inline constexpr auto powers_of_10 = [] {
+			std::array<std::uint64_t, 20> result{ };
+			std::uint64_t p = 1;
+			for( auto &v : result ) {
+				v = p;
+				p *= 10U;
+			}
+			return result;
+		}( );
+
+		/// The most characters an integer of type T formats to, including a sign
+		template<typename T>
+		inline constexpr std::size_t max_formatted_digits =
+		  static_cast<std::size_t>( daw::numeric_limits<T>::digits10 ) + 2U;
+
 		template<typename T>
 		using base_int_type_t =
 		  typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
 		                              daw::traits::identity<T>>::type;
 
-		template<typename T>
-		static constexpr void reverse( T *first, T *last ) {
-			// Assume preconditions. This helps on CE in codegen but may
-			// not matter here with inlining
-			DAW_ASSUME( first and last );
-			DAW_ASSUME( first <= last );
-			auto rpos = last - first;
-			auto lpos = 0;
-			while( lpos < rpos ) {
-				--rpos;
-				auto tmp = DAW_MOVE( first[lpos] );
-				first[lpos] = DAW_MOVE( first[rpos] );
-				first[rpos] = DAW_MOVE( tmp );
-				++lpos;
+		/// The unsigned type the digits of Unsigned are generated in, so that
+		/// small types do not promote and 32 bit values use 32 bit division
+		template<typename Unsigned>
+		using digits_type_t = std::conditional_t<
+		  ( sizeof( Unsigned ) <= sizeof( std::uint32_t ) ), std::uint32_t,
+		  std::conditional_t<( sizeof( Unsigned ) <= sizeof( std::uint64_t ) ),
+		                     std::uint64_t, Unsigned>>;
+
+		/// @brief The number of decimal digits in v, at least 1.  The bit width
+		/// of v gives floor( log10 ) or one less, a table lookup corrects it
+		template<typename Unsigned>
+		[[nodiscard]] constexpr std::size_t digit_count( Unsigned v ) {
+			if constexpr( sizeof( Unsigned ) > sizeof( std::uint64_t ) ) {
+				std::size_t result = 1;
+				while( v >= 10U ) {
+					v /= 10U;
+					++result;
+				}
+				return result;
+			} else {
+				// Setting the low bit makes 0 count as 1 digit and does not change
+				// the count of other values
+				auto const x = static_cast<std::uint64_t>( v ) | 1U;
+				auto const bits =
+				  static_cast<std::size_t>( 64 - std::countl_zero( x ) );
+				auto const guess = ( bits * 1233U ) >> 12U;
+				return guess + ( x >= powers_of_10[guess] ? 1U : 0U );
+			}
+		}
+
+		/// @brief Write the count digits of v to [first, first + count), from
+		/// the last digit back, so no reversal is needed
+		template<typename Unsigned>
+		constexpr void write_digits( char *first, std::size_t count,
+		                             Unsigned v ) {
+			DAW_ASSUME( first );
+			char *ptr = first + count;
+			while( v >= 100U ) {
+				auto const tmp = static_cast<std::size_t>( v % 100U );
+				v /= 100U;
+				ptr -= 2;
+				ptr[0] = digit_pairs[tmp][0];
+				ptr[1] = digit_pairs[tmp][1];
+			}
+			if( v >= 10U ) {
+				ptr -= 2;
+				ptr[0] = digit_pairs[static_cast<std::size_t>( v )][0];
+				ptr[1] = digit_pairs[static_cast<std::size_t>( v )][1];
+			} else {
+				*--ptr = static_cast<char>( '0' + static_cast<char>( v ) );
 			}
 		}
 
@@ -64,27 +122,14 @@ namespace daw::io::type_writer {
 				}
 			} else if constexpr( std::disjunction_v<std::is_enum<Integer>,
 			                                        daw::is_integral<Integer>> ) {
-				auto v = static_cast<under_type>( value );
-
-				if( DAW_UNLIKELY( v == 0 ) ) {
-					return writer.put( '0' );
-				} else {
-					daw_io_assert( v > 0, "Unexpected number value" );
-					char buff[daw::numeric_limits<under_type>::digits10 + 10]{ };
-					char *ptr = buff;
-					while( v >= 10 ) {
-						auto const tmp = v % 100U;
-						v /= 100U;
-						ptr[0] = digits100[tmp][0];
-						ptr[1] = digits100[tmp][1];
-						ptr += 2;
-					}
-					if( v > 0 ) {
-						*ptr++ = static_cast<char>( '0' + static_cast<char>( v ) );
-					}
-					reverse( buff, ptr );
-					return writer.write( daw::string_view( +buff, ptr ) );
-				}
+				auto const v = static_cast<digits_type_t<under_type>>(
+				  static_cast<under_type>( value ) );
+				auto const count = digit_count( v );
+				return daw::io::write_direct<max_formatted_digits<under_type>>(
+				  writer, count, [&]( std::span<char> buff ) -> std::size_t {
+					  write_digits( buff.data( ), count, v );
+					  return count;
+				  } );
 			}
 			using std::to_string;
 			auto str_val = to_string( value );
@@ -99,41 +144,26 @@ namespace daw::io::type_writer {
 
 			if constexpr( std::disjunction_v<std::is_enum<Integer>,
 			                                 daw::is_integral<Integer>> ) {
-				auto v = static_cast<under_type>( value );
-
-				char buff[daw::numeric_limits<under_type>::digits10 + 10]{ };
-				char *num_start = buff;
-				char *ptr = buff;
-				if( v < 0 ) {
-					*ptr++ = '-';
-					++num_start;
-					// Do 1 round here just in case we are
-					// daw::numeric_limits<intmax_t>::min( ) and cannot negate
-					// This is a subtraction because when v < 0, v % 100 is negative
-					auto const tmp = -static_cast<std::size_t>( v % 10 );
-					v /= -10;
-					*ptr++ = digits100[tmp][0];
-					if( v == 0 ) {
-						return writer.write( daw::string_view( +buff, ptr ) );
-					}
-				}
-
-				if( v == 0 ) {
-					*ptr++ = '0';
-				}
-				while( v >= 10 ) {
-					auto const tmp = static_cast<std::size_t>( v % 100 );
-					v /= 100;
-					ptr[0] = digits100[tmp][0];
-					ptr[1] = digits100[tmp][1];
-					ptr += 2;
-				}
-				if( v > 0 ) {
-					*ptr++ = static_cast<char>( '0' + static_cast<char>( v ) );
-				}
-
-				reverse( num_start, ptr );
-				return writer.write( daw::string_view( +buff, ptr ) );
+				using unsigned_type =
+				  digits_type_t<std::make_unsigned_t<under_type>>;
+				auto const v = static_cast<under_type>( value );
+				bool const is_negative = v < 0;
+				// Negating in the unsigned type is defined for the minimum value
+				auto const magnitude =
+				  is_negative ? static_cast<unsigned_type>(
+				                  unsigned_type{ 0 } - static_cast<unsigned_type>( v ) )
+				              : static_cast<unsigned_type>( v );
+				auto const digits = digit_count( magnitude );
+				auto const count = digits + ( is_negative ? 1U : 0U );
+				return daw::io::write_direct<max_formatted_digits<under_type>>(
+				  writer, count, [&]( std::span<char> buff ) -> std::size_t {
+					  char *first = buff.data( );
+					  if( is_negative ) {
+						  *first++ = '-';
+					  }
+					  write_digits( first, digits, magnitude );
+					  return count;
+				  } );
 			}
 			// Fallback to ADL
 			using std::to_string;
@@ -141,6 +171,32 @@ namespace daw::io::type_writer {
 			return writer.write( str_val );
 		}
 	} // namespace impl
+
+	/// @brief The number of characters type_writer writes for i
+	template<
+	  typename Integer,
+	  std::enable_if_t<daw::is_integral_v<Integer>, std::nullptr_t> = nullptr>
+	[[nodiscard]] constexpr std::size_t type_writer_size( Integer const &i ) {
+		using under_type = impl::base_int_type_t<Integer>;
+		if constexpr( std::is_same_v<Integer, bool> ) {
+			(void)i;
+			return 1;
+		} else if constexpr( daw::is_unsigned_v<Integer> ) {
+			return impl::digit_count( static_cast<impl::digits_type_t<under_type>>(
+			  static_cast<under_type>( i ) ) );
+		} else {
+			using unsigned_type =
+			  impl::digits_type_t<std::make_unsigned_t<under_type>>;
+			auto const v = static_cast<under_type>( i );
+			if( v < 0 ) {
+				return impl::digit_count( static_cast<unsigned_type>(
+				         unsigned_type{ 0 } - static_cast<unsigned_type>( v ) ) ) +
+				       1U;
+			}
+			return impl::digit_count( static_cast<unsigned_type>( v ) );
+		}
+	}
+
 	template<
 	  typename Integer, typename Writer,
 	  std::enable_if_t<daw::is_integral_v<Integer>, std::nullptr_t> = nullptr>
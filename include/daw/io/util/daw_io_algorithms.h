@@ -11,81 +11,289 @@
 #include "daw/io/daw_read_proxy.h"
 #include "daw/io/daw_write_proxy.h"
 
+#include <daw/cpp_17.h>
+#include <daw/daw_algorithm.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
 namespace daw::io::util {
 	struct CopyResult {
 		IOOpResult read_result;
 		IOOpResult write_result;
 	};
+
+	/// @brief Use a heap buffer for transform/copy whose chunk size starts at
+	/// initial_size and doubles, up to max_size, each time a read fills the
+	/// whole chunk.  Small sources stay small and fast sources like files or
+	/// pipes move to large chunks, with fewer syscalls
+	struct adaptive_buffer {
+		std::size_t initial_size = 4096U;
+		std::size_t max_size = 1024U * 1024U;
+	};
+
+	/// @brief Specialize to let copy/copy_n move data from a Readable U to a
+	/// Writable T without a user space buffer, e.g. copy_file_range for file
+	/// descriptors.  Specializations must have
+	///   static CopyResult copy_n( T &, U &, std::size_t count )
+	/// where a count of std::numeric_limits<std::size_t>::max( ) means until
+	/// Eof.  When the fast path is not possible it returns Ok for both results
+	/// with the bytes copied so far and the remainder is copied through a buffer
+	template<typename T, typename U>
+	struct KernelCopy {};
+
 	namespace util_details {
 		struct copy_op {
 			explicit copy_op( ) = default;
 		};
-	} // namespace util_details
 
-	template<std::size_t BuffSize = 4096U>
-	struct transform_n_t {
-		explicit transform_n_t( ) = default;
+		inline constexpr std::size_t until_eof =
+		  std::numeric_limits<std::size_t>::max( );
 
-		template<typename T, typename U, typename Func>
+		template<typename T, typename U>
+		using has_kernel_copy_test = decltype( KernelCopy<T, U>::copy_n(
+		  std::declval<T &>( ), std::declval<U &>( ), std::size_t{ } ) );
+
+		template<typename T, typename U>
+		inline constexpr bool has_kernel_copy_v =
+		  daw::is_detected_v<has_kernel_copy_test, T, U>;
+
+		template<typename Func>
+		using has_transform_span_test =
+		  decltype( std::declval<Func &>( ).transform_span(
+		    std::declval<std::span<std::byte const>>( ),
+		    std::declval<std::byte *>( ), std::uint64_t{ } ) );
+
+		template<typename Func>
+		inline constexpr bool has_transform_span_v =
+		  daw::is_detected_v<has_transform_span_test, Func>;
+
+		/// @brief Apply func to count bytes of input, writing them to output,
+		/// which may be input.  position is the offset of input in the data
+		/// transformed
+		template<typename Func>
+		constexpr void transform_into( Func &func, std::byte const *input,
+		                               std::byte *output, std::size_t count,
+		                               std::uint64_t position ) {
+			if constexpr( has_transform_span_v<Func> ) {
+				func.transform_span( std::span<std::byte const>( input, count ), output,
+				                     position );
+			} else {
+				(void)position;
+				(void)daw::algorithm::transform_n( input, output, count, func );
+			}
+		}
+
+		/// @brief True when a KernelCopy result leaves nothing for the buffered
+		/// path to do
+		[[nodiscard]] constexpr bool kernel_copy_finished( CopyResult const &r,
+		                                                   std::size_t count ) {
+			return r.read_result.status != IOOpStatus::Ok or
+			       r.write_result.status != IOOpStatus::Ok or
+			       r.read_result.count == count;
+		}
+
+		/// @brief Combine the results of two copies, the latter done after the
+		/// former
+		[[nodiscard]] constexpr CopyResult combine( CopyResult const &first,
+		                                           CopyResult const &second ) {
+			return { { second.read_result.status,
+			           first.read_result.count + second.read_result.count },
+			         { second.write_result.status,
+			           first.write_result.count + second.write_result.count } };
+		}
+
+		/// @brief Copy count bytes, using KernelCopy when available and
+		/// buffered( remaining_count ) for whatever it did not copy
+		template<typename T, typename U, typename Buffered>
+		[[nodiscard]] constexpr CopyResult copy_with( Writer<T> &writer,
+		                                             Reader<U> &reader,
+		                                             std::size_t count,
+		                                             Buffered &&buffered ) {
+			if constexpr( has_kernel_copy_v<T, U> ) {
+				auto const kr = KernelCopy<T, U>::copy_n( writer.writable( ),
+				                                          reader.readable( ), count );
+				if( kernel_copy_finished( kr, count ) ) {
+					return kr;
+				}
+				return combine( kr, buffered( count - kr.read_result.count ) );
+			} else {
+				(void)writer;
+				(void)reader;
+				return buffered( count );
+			}
+		}
+
+		/// @brief Chunks are the front of a single buffer
+		class fixed_chunks {
+			std::span<std::byte> m_buffer;
+
+		public:
+			explicit constexpr fixed_chunks( std::span<std::byte> buffer )
+			  : m_buffer( buffer ) {
+				assert( not m_buffer.empty( ) );
+			}
+
+			[[nodiscard]] constexpr std::span<std::byte> next( std::size_t count ) {
+				return m_buffer.first( std::min( count, m_buffer.size( ) ) );
+			}
+
+			constexpr void filled( std::size_t ) {}
+		};
+
+		/// @brief Chunks from a heap buffer that grows while reads fill it
+		class adaptive_chunks {
+			std::unique_ptr<std::byte[]> m_buffer;
+			std::size_t m_capacity = 0;
+			std::size_t m_chunk_size;
+			std::size_t m_max_size;
+
+		public:
+			explicit adaptive_chunks( adaptive_buffer opts )
+			  : m_chunk_size( std::max( opts.initial_size, std::size_t{ 1 } ) )
+			  , m_max_size( std::max( opts.max_size, m_chunk_size ) ) {}
+
+			[[nodiscard]] std::span<std::byte> next( std::size_t count ) {
+				auto const sz = std::min( count, m_chunk_size );
+				if( sz > m_capacity ) {
+					// The previous contents have been written, no need to keep them
+					m_buffer = std::make_unique_for_overwrite<std::byte[]>( sz );
+					m_capacity = sz;
+				}
+				return std::span<std::byte>( m_buffer.get( ), sz );
+			}
+
+			/// @brief Record that a read returned count bytes.  Filling the whole
+			/// chunk means the source likely has more ready
+			void filled( std::size_t count ) {
+				if( count == m_chunk_size ) {
+					m_chunk_size = std::min( m_chunk_size * 2U, m_max_size );
+				}
+			}
+		};
+
+		/// @brief Read up to count bytes, a chunk at a time, from reader, apply
+		/// func to each byte and write them to writer.  Stops at Eof or an error
+		template<typename T, typename U, typename Func, typename Chunks>
 		[[nodiscard]] constexpr CopyResult
-		operator( )( Writer<T> &writer, Reader<U> &reader, std::size_t count,
-		             Func &&func ) {
-			static_assert( BuffSize > 0 );
-			std::byte buffer[BuffSize];
+		transform_chunks( Writer<T> &writer, Reader<U> &reader, std::size_t count,
+		                  Func &func, Chunks &chunks ) {
 			auto read_result = IOOpResult{ };
 			auto write_result = IOOpResult{ };
 			while( count > 0 and read_result.status == IOOpStatus::Ok and
 			       write_result.status == IOOpStatus::Ok ) {
-				auto buff_sp =
-				  std::span<std::byte>( buffer, std::min( count, BuffSize ) );
+				auto buff_sp = chunks.next( count );
 				auto const rr = reader.read( buff_sp );
 				read_result.status = rr.status;
 				read_result.count += rr.count;
 				count -= rr.count;
+				chunks.filled( rr.count );
 				if( rr.count > 0 ) {
-					if constexpr( not std::is_same_v<util_details::copy_op,
+					if constexpr( not std::is_same_v<copy_op,
 					                                 std::remove_cvref_t<Func>> ) {
-						(void)daw::algorithm::transform_n( buffer, buffer, rr.count, func );
+						transform_into( func, buff_sp.data( ), buff_sp.data( ), rr.count,
+						                read_result.count - rr.count );
 					}
-					buff_sp = std::span<std::byte>( buffer, rr.count );
-					auto const wr = writer.write( buff_sp );
+					buff_sp = buff_sp.first( rr.count );
+					auto const wr = writer.write( std::span<std::byte const>( buff_sp ) );
 					write_result.status = wr.status;
 					write_result.count += wr.count;
 				}
 			}
 			return { read_result, write_result };
 		}
-	};
-
-	template<>
-	struct transform_n_t<1> {
-		explicit transform_n_t( ) = default;
 
+		/// @brief Read up to count bytes, one at a time, from reader, apply func
+		/// to each byte and write them to writer.  Stops at Eof or an error
 		template<typename T, typename U, typename Func>
 		[[nodiscard]] constexpr CopyResult
-		operator( )( Writer<T> &writer, Reader<U> &reader, std::size_t count,
-		             Func &&func ) {
+		transform_bytes( Writer<T> &writer, Reader<U> &reader, std::size_t count,
+		                 Func &func ) {
 			auto read_result = IOOpResult{ };
 			auto write_result = IOOpResult{ };
 			while( count > 0 and read_result.status == IOOpStatus::Ok and
 			       write_result.status == IOOpStatus::Ok ) {
 				auto buff = std::byte{ 0 };
-				auto const rr = reader.get( buff ).status;
+				auto const rr = reader.get( buff );
 				read_result.status = rr.status;
 				read_result.count += rr.count;
 				count -= rr.count;
 				if( rr.count > 0 ) {
-					if constexpr( not std::is_same_v<util_details::copy_op,
+					if constexpr( not std::is_same_v<copy_op,
 					                                 std::remove_cvref_t<Func>> ) {
-						buff = func( buff );
+						transform_into( func, &buff, &buff, 1, read_result.count - 1 );
 					}
 					auto const wr = writer.put( buff );
 					write_result.status = wr.status;
-					write_result.count += wr.couunt;
+					write_result.count += wr.count;
 				}
 			}
 			return { read_result, write_result };
 		}
+	} // namespace util_details
+
+	/// @brief Transform count bytes from reader into writer.  By default
+	/// through a BuffSize stack buffer, or through a caller provided buffer or
+	/// an adaptive_buffer.  func is called with, and returns, each std::byte.
+	/// When it has a
+	///   void transform_span( std::span<std::byte const> input, std::byte *out,
+	///                        std::uint64_t position )
+	/// member, e.g. the kernels in daw_io_byte_kernels.h, that is called with
+	/// whole chunks instead.  position is the offset of input from the start of
+	/// the transform and out may be input.data( )
+	template<std::size_t BuffSize = 4096U>
+	struct transform_n_t {
+		explicit transform_n_t( ) = default;
+
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] constexpr CopyResult
+		operator( )( Writer<T> &writer, Reader<U> &reader, std::size_t count,
+		             Func &&func ) const {
+			static_assert( BuffSize > 0 );
+			std::byte buffer[BuffSize];
+			auto chunks = util_details::fixed_chunks( buffer );
+			return util_details::transform_chunks( writer, reader, count, func,
+			                                       chunks );
+		}
+
+		/// @param buffer Memory to read into and write from, it must not be empty
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] constexpr CopyResult
+		operator( )( Writer<T> &writer, Reader<U> &reader, std::size_t count,
+		             std::span<std::byte> buffer, Func &&func ) const {
+			auto chunks = util_details::fixed_chunks( buffer );
+			return util_details::transform_chunks( writer, reader, count, func,
+			                                       chunks );
+		}
+
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] CopyResult operator( )( Writer<T> &writer, Reader<U> &reader,
+		                                      std::size_t count,
+		                                      adaptive_buffer opts,
+		                                      Func &&func ) const {
+			auto chunks = util_details::adaptive_chunks( opts );
+			return util_details::transform_chunks( writer, reader, count, func,
+			                                       chunks );
+		}
+	};
+
+	template<>
+	struct transform_n_t<1> {
+		explicit transform_n_t( ) = default;
+
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] constexpr CopyResult
+		operator( )( Writer<T> &writer, Reader<U> &reader, std::size_t count,
+		             Func &&func ) const {
+			return util_details::transform_bytes( writer, reader, count, func );
+		}
 	};
 
 	inline constexpr auto transform_n = transform_n_t<4096>{ };
@@ -93,42 +301,71 @@ namespace daw::io::util {
 	template<std::size_t BuffSize>
 	inline constexpr auto transform_n_b = transform_n_t<BuffSize>{ };
 
+	/// @brief Copy count bytes from reader to writer.  When a KernelCopy
+	/// specialization exists for the types, e.g. file descriptor to file
+	/// descriptor, the data does not pass through user space
 	template<std::size_t BuffSize = 4096U, typename T, typename U>
 	[[nodiscard]] constexpr CopyResult
 	copy_n( Writer<T> &writer, Reader<U> &reader, std::size_t count ) {
-		return transform_n_b<BuffSize>( writer, reader, count,
-		                                util_details::copy_op{ } );
+		return util_details::copy_with(
+		  writer, reader, count, [&]( std::size_t remaining ) {
+			  return transform_n_b<BuffSize>( writer, reader, remaining,
+			                                  util_details::copy_op{ } );
+		  } );
+	}
+
+	/// @brief Copy count bytes from reader to writer through buffer when it
+	/// cannot be done in the kernel
+	template<typename T, typename U>
+	[[nodiscard]] constexpr CopyResult copy_n( Writer<T> &writer,
+	                                           Reader<U> &reader,
+	                                           std::size_t count,
+	                                           std::span<std::byte> buffer ) {
+		return util_details::copy_with(
+		  writer, reader, count, [&]( std::size_t remaining ) {
+			  return transform_n( writer, reader, remaining, buffer,
+			                      util_details::copy_op{ } );
+		  } );
 	}
 
+	template<typename T, typename U>
+	[[nodiscard]] CopyResult copy_n( Writer<T> &writer, Reader<U> &reader,
+	                                 std::size_t count, adaptive_buffer opts ) {
+		return util_details::copy_with(
+		  writer, reader, count, [&]( std::size_t remaining ) {
+			  return transform_n( writer, reader, remaining, opts,
+			                      util_details::copy_op{ } );
+		  } );
+	}
+
+	/// @brief Transform bytes from reader into writer until Eof or an error.  By
+	/// default through a BuffSize stack buffer, or through a caller provided
+	/// buffer or an adaptive_buffer
 	template<std::size_t BuffSize = 4096U>
 	struct transform_t {
 		explicit transform_t( ) = default;
 
 		template<typename T, typename U, typename Func>
 		[[nodiscard]] constexpr CopyResult
-		operator( )( Writer<T> &writer, Reader<U> &reader, Func &&func ) {
-			static_assert( BuffSize > 0 );
-			std::byte buffer[BuffSize];
-			auto read_result = IOOpResult{ };
-			auto write_result = IOOpResult{ };
-			while( read_result.status == IOOpStatus::Ok and
-			       write_result.status == IOOpStatus::Ok ) {
-				auto buff_sp = std::span<std::byte>( buffer, BuffSize );
-				auto const rr = reader.read( buff_sp );
-				read_result.status = rr.status;
-				read_result.count += rr.count;
-				if( rr.count > 0 ) {
-					buff_sp = std::span<std::byte>( buffer, rr.count );
-					if constexpr( not std::is_same_v<util_details::copy_op,
-					                                 std::remove_cvref_t<Func>> ) {
-						(void)daw::algorithm::transform_n( buffer, buffer, rr.count, func );
-					}
-					auto const wr = writer.write( buff_sp );
-					write_result.status = wr.status;
-					write_result.count += wr.count;
-				}
-			}
-			return { read_result, write_result };
+		operator( )( Writer<T> &writer, Reader<U> &reader, Func &&func ) const {
+			return transform_n_b<BuffSize>( writer, reader, util_details::until_eof,
+			                                func );
+		}
+
+		/// @param buffer Memory to read into and write from, it must not be empty
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] constexpr CopyResult
+		operator( )( Writer<T> &writer, Reader<U> &reader,
+		             std::span<std::byte> buffer, Func &&func ) const {
+			return transform_n( writer, reader, util_details::until_eof, buffer,
+			                    func );
+		}
+
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] CopyResult operator( )( Writer<T> &writer, Reader<U> &reader,
+		                                      adaptive_buffer opts,
+		                                      Func &&func ) const {
+			return transform_n( writer, reader, util_details::until_eof, opts, func );
 		}
 	};
 
@@ -138,26 +375,9 @@ namespace daw::io::util {
 
 		template<typename T, typename U, typename Func>
 		[[nodiscard]] constexpr CopyResult
-		operator( )( Writer<T> &writer, Reader<U> &reader, Func &&func ) {
-			auto read_result = IOOpResult{ };
-			auto write_result = IOOpResult{ };
-			while( read_result.status == IOOpStatus::Ok and
-			       write_result.status == IOOpStatus::Ok ) {
-				auto buff = std::byte{ 0 };
-				auto const rr = reader.get( buff );
-				read_result.status = rr.status;
-				read_result.count += rr.count;
-				if( rr.count > 0 ) {
-					if constexpr( not std::is_same_v<util_details::copy_op,
-					                                 std::remove_cvref_t<Func>> ) {
-						buff = func( buff );
-					}
-					auto const wr = writer.put( buff );
-					write_result.status = wr.status;
-					write_result.count += wr.count;
-				}
-			}
-			return { read_result, write_result };
+		operator( )( Writer<T> &writer, Reader<U> &reader, Func &&func ) const {
+			return util_details::transform_bytes( writer, reader,
+			                                      util_details::until_eof, func );
 		}
 	};
 	inline constexpr auto transform = transform_t<4096>{ };
@@ -165,10 +385,26 @@ namespace daw::io::util {
 	template<std::size_t BuffSize>
 	inline constexpr auto transform_b = transform_t<BuffSize>{ };
 
+	/// @brief Copy from reader to writer until Eof or an error.  When a
+	/// KernelCopy specialization exists for the types, e.g. file descriptor to
+	/// file descriptor, the data does not pass through user space
 	template<std::size_t BuffSize = 4096U, typename T, typename U>
 	[[nodiscard]] constexpr CopyResult copy( Writer<T> &writer,
 	                                         Reader<U> &reader ) {
-		return transform_n_b<BuffSize>( writer, reader, util_details::copy_op{ } );
+		return copy_n<BuffSize>( writer, reader, util_details::until_eof );
+	}
+
+	/// @brief Copy from reader to writer until Eof or an error, through buffer
+	/// when it cannot be done in the kernel
+	template<typename T, typename U>
+	[[nodiscard]] constexpr CopyResult copy( Writer<T> &writer, Reader<U> &reader,
+	                                         std::span<std::byte> buffer ) {
+		return copy_n( writer, reader, util_details::until_eof, buffer );
 	}
 
+	template<typename T, typename U>
+	[[nodiscard]] CopyResult copy( Writer<T> &writer, Reader<U> &reader,
+	                               adaptive_buffer opts ) {
+		return copy_n( writer, reader, util_details::until_eof, opts );
+	}
 } // namespace daw::io::util
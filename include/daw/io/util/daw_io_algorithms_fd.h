@@ -0,0 +1,125 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw/io/daw_io_fd_wrap.h"
+#include "daw/io/daw_read_fd.h"
+#include "daw/io/daw_write_fd.h"
+#include "daw_io_algorithms.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined( __linux__ )
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace daw::io::util {
+	namespace util_details {
+		/// The most Linux will transfer in one read/write/sendfile style call
+		inline constexpr std::size_t kernel_copy_max_chunk = 0x7FFF'F000U;
+
+		enum class kernel_copy_status { Copied, Eof, Unsupported, Error };
+
+		/// @brief Errors meaning the syscall cannot be used for this pair of file
+		/// descriptors, e.g. different filesystems, a pipe or socket where a file
+		/// is needed, or an O_APPEND output.  A real problem with the file
+		/// descriptors is reported again by the next method tried
+		[[nodiscard]] inline bool is_kernel_copy_unsupported( int err ) {
+			return err == EXDEV or err == EINVAL or err == ENOSYS or
+			       err == EOPNOTSUPP or err == EBADF or err == ESPIPE;
+		}
+
+		/// @brief Call syscall( len ) until count bytes, including those in
+		/// copied already, have been transferred
+		/// @param zero_is_unsupported When the syscall has not transferred anything
+		/// yet, treat a 0 result as unsupported instead of Eof.  copy_file_range
+		/// returns 0 for some special files that do have data
+		template<typename Syscall>
+		[[nodiscard]] kernel_copy_status
+		kernel_copy_with( Syscall syscall, std::size_t count, std::size_t &copied,
+		                  bool zero_is_unsupported ) {
+			bool progress = false;
+			while( copied < count ) {
+				auto const len = std::min( count - copied, kernel_copy_max_chunk );
+				::ssize_t const result = syscall( len );
+				if( result > 0 ) {
+					copied += static_cast<std::size_t>( result );
+					progress = true;
+					continue;
+				}
+				if( result == 0 ) {
+					if( zero_is_unsupported and not progress ) {
+						return kernel_copy_status::Unsupported;
+					}
+					return kernel_copy_status::Eof;
+				}
+				if( errno == EINTR ) {
+					continue;
+				}
+				return is_kernel_copy_unsupported( errno )
+				         ? kernel_copy_status::Unsupported
+				         : kernel_copy_status::Error;
+			}
+			return kernel_copy_status::Copied;
+		}
+	} // namespace util_details
+
+	/// @brief Copy between file descriptors inside the kernel.  copy_file_range
+	/// is tried first, for files on the same filesystem this can share extents.
+	/// Then sendfile, whose input must be mmap-able like a regular file, and
+	/// splice, when the input is a pipe.  When none apply the caller falls back
+	/// to copying through a buffer.  The file offsets of both descriptors are
+	/// used and advanced like read/write would.  The kernel does not say which
+	/// side failed, so on error both results are Error
+	template<>
+	struct KernelCopy<fd_wrap_t, fd_wrap_t> {
+		[[nodiscard]] static CopyResult copy_n( fd_wrap_t out, fd_wrap_t in,
+		                                        std::size_t count ) {
+			using util_details::kernel_copy_status;
+			std::size_t copied = 0;
+			auto status = util_details::kernel_copy_with(
+			  [&]( std::size_t len ) {
+				  return ::copy_file_range( in.value, nullptr, out.value, nullptr, len,
+				                            0U );
+			  },
+			  count, copied, true );
+			if( status == kernel_copy_status::Unsupported ) {
+				status = util_details::kernel_copy_with(
+				  [&]( std::size_t len ) {
+					  return ::sendfile( out.value, in.value, nullptr, len );
+				  },
+				  count, copied, false );
+			}
+			if( status == kernel_copy_status::Unsupported ) {
+				status = util_details::kernel_copy_with(
+				  [&]( std::size_t len ) {
+					  return ::splice( in.value, nullptr, out.value, nullptr, len,
+					                   SPLICE_F_MOVE );
+				  },
+				  count, copied, false );
+			}
+			switch( status ) {
+			case kernel_copy_status::Eof:
+				return { { IOOpStatus::Eof, copied }, { IOOpStatus::Ok, copied } };
+			case kernel_copy_status::Error:
+				return { { IOOpStatus::Error, copied },
+				         { IOOpStatus::Error, copied } };
+			case kernel_copy_status::Copied:
+			case kernel_copy_status::Unsupported:
+				break;
+			}
+			return { { IOOpStatus::Ok, copied }, { IOOpStatus::Ok, copied } };
+		}
+	};
+} // namespace daw::io::util
+#endif
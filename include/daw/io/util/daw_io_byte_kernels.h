@@ -0,0 +1,443 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#if defined( __x86_64__ ) or defined( _M_X64 )
+#include <emmintrin.h>
+#if defined( __GNUC__ ) or defined( __clang__ )
+#include <immintrin.h>
+#endif
+#elif defined( __aarch64__ ) or defined( _M_ARM64 )
+#include <arm_neon.h>
+#endif
+
+namespace daw::io::util {
+	namespace util_details {
+		/// Each kernel has a scalar loop and vector loops that return how many
+		/// bytes they did, always a multiple of their width.  The rest is left to
+		/// the scalar loop
+
+		inline void translate_scalar( std::byte const *input, std::byte *output,
+		                              std::size_t count, std::byte const *table ) {
+			for( std::size_t n = 0; n < count; ++n ) {
+				output[n] = table[std::to_integer<unsigned char>( input[n] )];
+			}
+		}
+
+		/// @brief Flip the case bit of the bytes in [first, first + 26)
+		inline void ascii_case_scalar( std::byte const *input, std::byte *output,
+		                               std::size_t count, unsigned char first ) {
+			for( std::size_t n = 0; n < count; ++n ) {
+				auto const c = std::to_integer<unsigned char>( input[n] );
+				output[n] = static_cast<unsigned char>( c - first ) < 26U
+				              ? input[n] ^ std::byte{ 0x20 }
+				              : input[n];
+			}
+		}
+
+		inline void xor_mask_scalar( std::byte const *input, std::byte *output,
+		                             std::size_t count,
+		                             std::array<std::byte, 4> const &key,
+		                             std::uint64_t position ) {
+			for( std::size_t n = 0; n < count; ++n ) {
+				auto const k = static_cast<std::size_t>( ( position + n ) % 4U );
+				output[n] = input[n] ^ key[k];
+			}
+		}
+
+		inline void replace_scalar( std::byte const *input, std::byte *output,
+		                            std::size_t count, std::byte from,
+		                            std::byte to ) {
+			for( std::size_t n = 0; n < count; ++n ) {
+				output[n] = input[n] == from ? to : input[n];
+			}
+		}
+
+		/// @brief The 4 key bytes starting at key[position % 4], so that a
+		/// vector of them lines up with input at position
+		[[nodiscard]] inline std::uint32_t
+		xor_mask_pattern( std::array<std::byte, 4> const &key,
+		                  std::uint64_t position ) {
+			std::byte rotated[4];
+			for( std::size_t n = 0; n < 4U; ++n ) {
+				rotated[n] = key[static_cast<std::size_t>( ( position + n ) % 4U )];
+			}
+			std::uint32_t result = 0;
+			std::memcpy( &result, rotated, sizeof( result ) );
+			return result;
+		}
+
+#if defined( __x86_64__ ) or defined( _M_X64 )
+		// SSE2 is part of x86_64, it needs no detection
+		inline std::size_t ascii_case_sse2( std::byte const *input,
+		                                    std::byte *output, std::size_t count,
+		                                    unsigned char first ) {
+			// Move [first, first + 26) to the bottom of the signed range so one
+			// signed compare finds it
+			auto const bias = _mm_set1_epi8( static_cast<char>( 0x80 - first ) );
+			auto const limit = _mm_set1_epi8( static_cast<char>( 0x80 + 26 ) );
+			auto const flip = _mm_set1_epi8( 0x20 );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto const x =
+				  _mm_loadu_si128( reinterpret_cast<__m128i const *>( input + n ) );
+				auto const in_range = _mm_cmplt_epi8( _mm_add_epi8( x, bias ), limit );
+				_mm_storeu_si128( reinterpret_cast<__m128i *>( output + n ),
+				                  _mm_xor_si128( x, _mm_and_si128( in_range, flip ) ) );
+			}
+			return n;
+		}
+
+		inline std::size_t xor_mask_sse2( std::byte const *input,
+		                                  std::byte *output, std::size_t count,
+		                                  std::uint32_t pattern ) {
+			auto const key = _mm_set1_epi32( static_cast<int>( pattern ) );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto const x =
+				  _mm_loadu_si128( reinterpret_cast<__m128i const *>( input + n ) );
+				_mm_storeu_si128( reinterpret_cast<__m128i *>( output + n ),
+				                  _mm_xor_si128( x, key ) );
+			}
+			return n;
+		}
+
+		inline std::size_t replace_sse2( std::byte const *input, std::byte *output,
+		                                 std::size_t count, std::byte from,
+		                                 std::byte to ) {
+			auto const from_v = _mm_set1_epi8(
+			  static_cast<char>( std::to_integer<unsigned char>( from ) ) );
+			auto const to_v = _mm_set1_epi8(
+			  static_cast<char>( std::to_integer<unsigned char>( to ) ) );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto const x =
+				  _mm_loadu_si128( reinterpret_cast<__m128i const *>( input + n ) );
+				auto const found = _mm_cmpeq_epi8( x, from_v );
+				_mm_storeu_si128( reinterpret_cast<__m128i *>( output + n ),
+				                  _mm_or_si128( _mm_andnot_si128( found, x ),
+				                                _mm_and_si128( found, to_v ) ) );
+			}
+			return n;
+		}
+
+#if defined( __GNUC__ ) or defined( __clang__ )
+		/// @return true when the CPU running this has AVX2
+		[[nodiscard]] inline bool has_avx2( ) {
+			static bool const result = [] {
+				__builtin_cpu_init( );
+				return __builtin_cpu_supports( "avx2" ) != 0;
+			}( );
+			return result;
+		}
+
+		[[gnu::target( "avx2" )]] inline std::size_t
+		ascii_case_avx2( std::byte const *input, std::byte *output,
+		                 std::size_t count, unsigned char first ) {
+			auto const bias = _mm256_set1_epi8( static_cast<char>( 0x80 - first ) );
+			auto const limit = _mm256_set1_epi8( static_cast<char>( 0x80 + 26 ) );
+			auto const flip = _mm256_set1_epi8( 0x20 );
+			std::size_t n = 0;
+			for( ; n + 32U <= count; n += 32U ) {
+				auto const x =
+				  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( input + n ) );
+				auto const in_range =
+				  _mm256_cmpgt_epi8( limit, _mm256_add_epi8( x, bias ) );
+				_mm256_storeu_si256(
+				  reinterpret_cast<__m256i *>( output + n ),
+				  _mm256_xor_si256( x, _mm256_and_si256( in_range, flip ) ) );
+			}
+			return n;
+		}
+
+		[[gnu::target( "avx2" )]] inline std::size_t
+		xor_mask_avx2( std::byte const *input, std::byte *output,
+		               std::size_t count, std::uint32_t pattern ) {
+			auto const key = _mm256_set1_epi32( static_cast<int>( pattern ) );
+			std::size_t n = 0;
+			for( ; n + 32U <= count; n += 32U ) {
+				auto const x =
+				  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( input + n ) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( output + n ),
+				                     _mm256_xor_si256( x, key ) );
+			}
+			return n;
+		}
+
+		[[gnu::target( "avx2" )]] inline std::size_t
+		replace_avx2( std::byte const *input, std::byte *output, std::size_t count,
+		              std::byte from, std::byte to ) {
+			auto const from_v = _mm256_set1_epi8(
+			  static_cast<char>( std::to_integer<unsigned char>( from ) ) );
+			auto const to_v = _mm256_set1_epi8(
+			  static_cast<char>( std::to_integer<unsigned char>( to ) ) );
+			std::size_t n = 0;
+			for( ; n + 32U <= count; n += 32U ) {
+				auto const x =
+				  _mm256_loadu_si256( reinterpret_cast<__m256i const *>( input + n ) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i *>( output + n ),
+				                     _mm256_blendv_epi8(
+				                       x, to_v, _mm256_cmpeq_epi8( x, from_v ) ) );
+			}
+			return n;
+		}
+#endif
+#elif defined( __aarch64__ ) or defined( _M_ARM64 )
+		// NEON is part of AArch64, it needs no detection
+		/// @brief tbl looks up 64 entries at a time and gives 0 for indices past
+		/// them, so the four quarters of the table are looked up and or'ed
+		inline std::size_t translate_neon( std::byte const *input,
+		                                   std::byte *output, std::size_t count,
+		                                   std::byte const *table ) {
+			auto const *tbl = reinterpret_cast<std::uint8_t const *>( table );
+			uint8x16x4_t const quarters[4] = { vld1q_u8_x4( tbl ),
+			                                   vld1q_u8_x4( tbl + 64 ),
+			                                   vld1q_u8_x4( tbl + 128 ),
+			                                   vld1q_u8_x4( tbl + 192 ) };
+			auto const quarter = vdupq_n_u8( 64 );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto idx =
+				  vld1q_u8( reinterpret_cast<std::uint8_t const *>( input + n ) );
+				auto result = vqtbl4q_u8( quarters[0], idx );
+				for( std::size_t q = 1; q < 4U; ++q ) {
+					idx = vsubq_u8( idx, quarter );
+					result = vorrq_u8( result, vqtbl4q_u8( quarters[q], idx ) );
+				}
+				vst1q_u8( reinterpret_cast<std::uint8_t *>( output + n ), result );
+			}
+			return n;
+		}
+
+		inline std::size_t ascii_case_neon( std::byte const *input,
+		                                    std::byte *output, std::size_t count,
+		                                    unsigned char first ) {
+			auto const first_v = vdupq_n_u8( first );
+			auto const limit = vdupq_n_u8( 26 );
+			auto const flip = vdupq_n_u8( 0x20 );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto const x =
+				  vld1q_u8( reinterpret_cast<std::uint8_t const *>( input + n ) );
+				auto const in_range = vcltq_u8( vsubq_u8( x, first_v ), limit );
+				vst1q_u8( reinterpret_cast<std::uint8_t *>( output + n ),
+				          veorq_u8( x, vandq_u8( in_range, flip ) ) );
+			}
+			return n;
+		}
+
+		inline std::size_t xor_mask_neon( std::byte const *input,
+		                                  std::byte *output, std::size_t count,
+		                                  std::uint32_t pattern ) {
+			auto const key = vreinterpretq_u8_u32( vdupq_n_u32( pattern ) );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto const x =
+				  vld1q_u8( reinterpret_cast<std::uint8_t const *>( input + n ) );
+				vst1q_u8( reinterpret_cast<std::uint8_t *>( output + n ),
+				          veorq_u8( x, key ) );
+			}
+			return n;
+		}
+
+		inline std::size_t replace_neon( std::byte const *input,
+		                                 std::byte *output, std::size_t count,
+		                                 std::byte from, std::byte to ) {
+			auto const from_v = vdupq_n_u8( std::to_integer<std::uint8_t>( from ) );
+			auto const to_v = vdupq_n_u8( std::to_integer<std::uint8_t>( to ) );
+			std::size_t n = 0;
+			for( ; n + 16U <= count; n += 16U ) {
+				auto const x =
+				  vld1q_u8( reinterpret_cast<std::uint8_t const *>( input + n ) );
+				vst1q_u8( reinterpret_cast<std::uint8_t *>( output + n ),
+				          vbslq_u8( vceqq_u8( x, from_v ), to_v, x ) );
+			}
+			return n;
+		}
+#endif
+
+		inline void translate_bytes( std::byte const *input, std::byte *output,
+		                             std::size_t count, std::byte const *table ) {
+			std::size_t done = 0;
+#if defined( __aarch64__ ) or defined( _M_ARM64 )
+			done = translate_neon( input, output, count, table );
+#endif
+			// x86 has no shuffle over more than 16 entries before AVX-512 VBMI, and
+			// splitting the table into 16 rows is no faster than the scalar loop
+			translate_scalar( input + done, output + done, count - done, table );
+		}
+
+		inline void ascii_case_bytes( std::byte const *input, std::byte *output,
+		                              std::size_t count, unsigned char first ) {
+			std::size_t done = 0;
+#if defined( __x86_64__ ) or defined( _M_X64 )
+#if defined( __GNUC__ ) or defined( __clang__ )
+			if( has_avx2( ) ) {
+				done = ascii_case_avx2( input, output, count, first );
+			}
+#endif
+			done += ascii_case_sse2( input + done, output + done, count - done,
+			                         first );
+#elif defined( __aarch64__ ) or defined( _M_ARM64 )
+			done = ascii_case_neon( input, output, count, first );
+#endif
+			ascii_case_scalar( input + done, output + done, count - done, first );
+		}
+
+		inline void xor_mask_bytes( std::byte const *input, std::byte *output,
+		                            std::size_t count,
+		                            std::array<std::byte, 4> const &key,
+		                            std::uint64_t position ) {
+			std::size_t done = 0;
+#if defined( __x86_64__ ) or defined( _M_X64 ) or defined( __aarch64__ ) or \
+  defined( _M_ARM64 )
+			// Vectors are a multiple of the key size, so the pattern is the same
+			// for all of them
+			auto const pattern = xor_mask_pattern( key, position );
+#endif
+#if defined( __x86_64__ ) or defined( _M_X64 )
+#if defined( __GNUC__ ) or defined( __clang__ )
+			if( has_avx2( ) ) {
+				done = xor_mask_avx2( input, output, count, pattern );
+			}
+#endif
+			done += xor_mask_sse2( input + done, output + done, count - done,
+			                       pattern );
+#elif defined( __aarch64__ ) or defined( _M_ARM64 )
+			done = xor_mask_neon( input, output, count, pattern );
+#endif
+			xor_mask_scalar( input + done, output + done, count - done, key,
+			                 position + done );
+		}
+
+		inline void replace_bytes( std::byte const *input, std::byte *output,
+		                           std::size_t count, std::byte from,
+		                           std::byte to ) {
+			std::size_t done = 0;
+#if defined( __x86_64__ ) or defined( _M_X64 )
+#if defined( __GNUC__ ) or defined( __clang__ )
+			if( has_avx2( ) ) {
+				done = replace_avx2( input, output, count, from, to );
+			}
+#endif
+			done += replace_sse2( input + done, output + done, count - done, from,
+			                      to );
+#elif defined( __aarch64__ ) or defined( _M_ARM64 )
+			done = replace_neon( input, output, count, from, to );
+#endif
+			replace_scalar( input + done, output + done, count - done, from, to );
+		}
+	} // namespace util_details
+
+	/// @brief Replace each byte b with table[b]
+	class translate_table {
+		std::array<std::byte, 256> m_table;
+
+	public:
+		explicit constexpr translate_table(
+		  std::array<std::byte, 256> const &table ) noexcept
+		  : m_table( table ) {}
+
+		/// @brief The table of func( b ) for every byte b
+		template<typename Func>
+		[[nodiscard]] static constexpr translate_table from( Func &&func ) {
+			auto table = std::array<std::byte, 256>{ };
+			for( std::size_t n = 0; n < table.size( ); ++n ) {
+				table[n] = func( static_cast<std::byte>( n ) );
+			}
+			return translate_table( table );
+		}
+
+		[[nodiscard]] constexpr std::byte operator( )( std::byte b ) const {
+			return m_table[std::to_integer<unsigned char>( b )];
+		}
+
+		void transform_span( std::span<std::byte const> input, std::byte *output,
+		                     std::uint64_t ) const {
+			util_details::translate_bytes( input.data( ), output, input.size( ),
+			                               m_table.data( ) );
+		}
+	};
+
+	/// @brief Convert a-z to A-Z, leaving all other bytes as they are
+	struct ascii_to_upper {
+		[[nodiscard]] constexpr std::byte operator( )( std::byte b ) const {
+			auto const c = std::to_integer<unsigned char>( b );
+			return c >= 'a' and c <= 'z' ? b ^ std::byte{ 0x20 } : b;
+		}
+
+		void transform_span( std::span<std::byte const> input, std::byte *output,
+		                     std::uint64_t ) const {
+			util_details::ascii_case_bytes( input.data( ), output, input.size( ),
+			                                'a' );
+		}
+	};
+
+	/// @brief Convert A-Z to a-z, leaving all other bytes as they are
+	struct ascii_to_lower {
+		[[nodiscard]] constexpr std::byte operator( )( std::byte b ) const {
+			auto const c = std::to_integer<unsigned char>( b );
+			return c >= 'A' and c <= 'Z' ? b ^ std::byte{ 0x20 } : b;
+		}
+
+		void transform_span( std::span<std::byte const> input, std::byte *output,
+		                     std::uint64_t ) const {
+			util_details::ascii_case_bytes( input.data( ), output, input.size( ),
+			                                'A' );
+		}
+	};
+
+	/// @brief Replace every from byte with to
+	class replace_byte {
+		std::byte m_from;
+		std::byte m_to;
+
+	public:
+		constexpr replace_byte( std::byte from, std::byte to ) noexcept
+		  : m_from( from )
+		  , m_to( to ) {}
+
+		constexpr replace_byte( char from, char to ) noexcept
+		  : m_from( static_cast<std::byte>( from ) )
+		  , m_to( static_cast<std::byte>( to ) ) {}
+
+		[[nodiscard]] constexpr std::byte operator( )( std::byte b ) const {
+			return b == m_from ? m_to : b;
+		}
+
+		void transform_span( std::span<std::byte const> input, std::byte *output,
+		                     std::uint64_t ) const {
+			util_details::replace_bytes( input.data( ), output, input.size( ),
+			                             m_from, m_to );
+		}
+	};
+
+	/// @brief XOR the data with a repeating 4 byte key, as WebSocket masking
+	/// does.  The key byte used depends on the position in the data, so it has
+	/// no single byte operator( ).  Applying it twice gives back the data
+	class xor_mask {
+		std::array<std::byte, 4> m_key;
+
+	public:
+		explicit constexpr xor_mask( std::array<std::byte, 4> const &key ) noexcept
+		  : m_key( key ) {}
+
+		void transform_span( std::span<std::byte const> input, std::byte *output,
+		                     std::uint64_t position ) const {
+			util_details::xor_mask_bytes( input.data( ), output, input.size( ),
+			                              m_key, position );
+		}
+	};
+} // namespace daw::io::util
@@ -0,0 +1,369 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_algorithms.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw::io::util {
+	enum class record_order {
+		/// Batch outputs are written in the order of the input
+		ordered,
+		/// Batch outputs are written as soon as they are ready
+		unordered
+	};
+
+	/// @brief How for_each_record_parallel splits its input between threads
+	struct record_options {
+		/// The number of worker threads, 0 for std::thread::hardware_concurrency
+		std::size_t thread_count = 0;
+		/// The bytes read per batch, extended to the end of a record
+		std::size_t block_size = 1024U * 1024U;
+		record_order order = record_order::ordered;
+	};
+
+	namespace util_details {
+		enum class batch_state { empty, filled, processing, done };
+
+		/// @brief Whole records from the input, and what func wrote for them
+		struct record_batch {
+			std::unique_ptr<char[]> input;
+			std::size_t capacity = 0;
+			std::size_t size = 0;
+			std::size_t sequence = 0;
+			std::string output;
+			batch_state state = batch_state::empty;
+
+			void reserve( std::size_t n ) {
+				if( n <= capacity ) {
+					return;
+				}
+				auto new_input = std::make_unique_for_overwrite<char[]>( n );
+				if( size > 0 ) {
+					std::memcpy( new_input.get( ), input.get( ), size );
+				}
+				input = std::move( new_input );
+				capacity = n;
+			}
+		};
+
+		/// @return One past the last delimiter in [first, first + size), or 0
+		[[nodiscard]] inline std::size_t end_of_last_record( char const *first,
+		                                                     std::size_t size,
+		                                                     char delimiter ) {
+			while( size > 0 ) {
+				if( first[size - 1U] == delimiter ) {
+					return size;
+				}
+				--size;
+			}
+			return 0;
+		}
+
+		template<typename Func>
+		void call_record( Func &func, daw::string_view record,
+		                  Writer<std::string> &out ) {
+			if constexpr( std::is_invocable_v<Func &, daw::string_view,
+			                                  Writer<std::string> &> ) {
+				func( record, out );
+			} else {
+				(void)out;
+				func( record );
+			}
+		}
+
+		/// @brief Call func with each record of the batch.  A final record
+		/// without a delimiter is included
+		template<typename Func>
+		void process_batch( record_batch &batch, char delimiter, Func &func ) {
+			batch.output.clear( );
+			auto out = Writer<std::string>( batch.output );
+			char const *first = batch.input.get( );
+			char const *const last = first + batch.size;
+			while( first != last ) {
+				auto const *found = static_cast<char const *>( std::memchr(
+				  first, delimiter, static_cast<std::size_t>( last - first ) ) );
+				auto const *record_last = found == nullptr ? last : found;
+				call_record( func,
+				             daw::string_view(
+				               first, static_cast<std::size_t>( record_last - first ) ),
+				             out );
+				first = found == nullptr ? last : found + 1;
+			}
+		}
+
+		/// @brief The calling thread reads batches and writes their output with
+		/// write_output( std::string const & ), the workers call func for the
+		/// records.  At most two batches per worker are in memory
+		template<typename U, typename Func, typename WriteOutput>
+		[[nodiscard]] CopyResult
+		for_each_record_impl( Reader<U> &reader, char delimiter, Func &func,
+		                      record_options opts, WriteOutput write_output ) {
+			auto thread_count = opts.thread_count;
+			if( thread_count == 0 ) {
+				thread_count =
+				  std::max( std::size_t{ std::thread::hardware_concurrency( ) },
+				            std::size_t{ 1 } );
+			}
+			auto const block_size = std::max( opts.block_size, std::size_t{ 1 } );
+			auto batches = std::vector<record_batch>( thread_count * 2U );
+			auto mut = std::mutex( );
+			auto work_cv = std::condition_variable( );
+			auto done_cv = std::condition_variable( );
+			bool no_more_input = false;
+			bool failed = false;
+			std::exception_ptr worker_exception = nullptr;
+
+			auto const find_batch = [&]( batch_state state ) -> record_batch * {
+				record_batch *result = nullptr;
+				for( auto &b : batches ) {
+					if( b.state == state and
+					    ( result == nullptr or b.sequence < result->sequence ) ) {
+						result = &b;
+					}
+				}
+				return result;
+			};
+
+			auto const work = [&] {
+				auto lock = std::unique_lock( mut );
+				while( true ) {
+					record_batch *batch = nullptr;
+					work_cv.wait( lock, [&] {
+						batch = find_batch( batch_state::filled );
+						return batch != nullptr or no_more_input;
+					} );
+					if( batch == nullptr ) {
+						return;
+					}
+					batch->state = batch_state::processing;
+					bool const skip = failed;
+					lock.unlock( );
+					std::exception_ptr ex = nullptr;
+					if( not skip ) {
+						try {
+							process_batch( *batch, delimiter, func );
+						} catch( ... ) {
+							ex = std::current_exception( );
+						}
+					}
+					lock.lock( );
+					if( ex and not failed ) {
+						worker_exception = ex;
+					}
+					failed = failed or ex != nullptr;
+					batch->state = batch_state::done;
+					done_cv.notify_all( );
+				}
+			};
+
+			auto read_result = IOOpResult{ };
+			auto write_result = IOOpResult{ };
+			std::exception_ptr caller_exception = nullptr;
+			std::size_t next_sequence = 0;
+			std::size_t next_write = 0;
+			// Write the output of the done batches that may go next, in order
+			// when asked to, and free them
+			auto const write_ready = [&]( std::unique_lock<std::mutex> &lock ) {
+				while( true ) {
+					record_batch *batch = nullptr;
+					if( opts.order == record_order::ordered ) {
+						for( auto &b : batches ) {
+							if( b.state == batch_state::done and b.sequence == next_write ) {
+								batch = &b;
+							}
+						}
+					} else {
+						batch = find_batch( batch_state::done );
+					}
+					if( batch == nullptr ) {
+						return;
+					}
+					if( not failed ) {
+						lock.unlock( );
+						auto const wr = write_output( batch->output );
+						lock.lock( );
+						write_result.status = wr.status;
+						write_result.count += wr.count;
+						failed = wr.status != IOOpStatus::Ok;
+					}
+					batch->state = batch_state::empty;
+					++next_write;
+				}
+			};
+
+			{
+				auto workers = std::vector<std::jthread>( );
+				workers.reserve( thread_count );
+				for( std::size_t n = 0; n < thread_count; ++n ) {
+					try {
+						workers.emplace_back( work );
+					} catch( std::system_error const & ) {
+						// Any worker can process any batch, so carry on with those that
+						// started.  Without any, nothing is waiting on work_cv yet
+						if( workers.empty( ) ) {
+							throw;
+						}
+						break;
+					}
+				}
+				try {
+					auto carry = std::string( );
+					while( read_result.status == IOOpStatus::Ok ) {
+						record_batch *batch = nullptr;
+						{
+							auto lock = std::unique_lock( mut );
+							while( true ) {
+								write_ready( lock );
+								batch = find_batch( batch_state::empty );
+								if( batch != nullptr or failed ) {
+									break;
+								}
+								done_cv.wait( lock );
+							}
+							if( failed ) {
+								break;
+							}
+						}
+						// The batch is empty so no other thread touches it
+						batch->size = 0;
+						batch->reserve( carry.size( ) + block_size );
+						std::memcpy( batch->input.get( ), carry.data( ), carry.size( ) );
+						batch->size = carry.size( );
+						std::size_t record_end = 0;
+						while( true ) {
+							auto const searched = batch->size;
+							auto const wanted = searched + block_size;
+							batch->reserve( wanted );
+							while( batch->size < wanted and
+							       read_result.status == IOOpStatus::Ok ) {
+								auto const rr = reader.read( std::span<char>(
+								  batch->input.get( ) + batch->size, wanted - batch->size ) );
+								read_result.status = rr.status;
+								read_result.count += rr.count;
+								batch->size += rr.count;
+							}
+							if( read_result.status == IOOpStatus::Eof ) {
+								record_end = batch->size;
+								break;
+							}
+							record_end =
+							  end_of_last_record( batch->input.get( ) + searched,
+							                      batch->size - searched, delimiter );
+							if( record_end > 0 ) {
+								record_end += searched;
+								break;
+							}
+							if( read_result.status == IOOpStatus::Error ) {
+								// Only the whole records before the error are used
+								record_end = end_of_last_record( batch->input.get( ),
+								                                 batch->size, delimiter );
+								break;
+							}
+							// A record longer than a block, keep reading
+						}
+						carry.assign( batch->input.get( ) + record_end,
+						              batch->size - record_end );
+						batch->size = record_end;
+						if( batch->size > 0 ) {
+							auto lock = std::unique_lock( mut );
+							batch->sequence = next_sequence++;
+							batch->state = batch_state::filled;
+							work_cv.notify_one( );
+						}
+					}
+					auto lock = std::unique_lock( mut );
+					no_more_input = true;
+					work_cv.notify_all( );
+					while( true ) {
+						write_ready( lock );
+						auto const all_written =
+						  std::all_of( batches.begin( ), batches.end( ), []( auto const &b ) {
+							  return b.state == batch_state::empty;
+						  } );
+						if( all_written ) {
+							break;
+						}
+						done_cv.wait( lock );
+					}
+				} catch( ... ) {
+					// Let the workers finish, skipping the remaining batches, so that
+					// they can be joined before rethrowing
+					caller_exception = std::current_exception( );
+					auto lock = std::unique_lock( mut );
+					failed = true;
+					no_more_input = true;
+					work_cv.notify_all( );
+				}
+			}
+			if( worker_exception ) {
+				std::rethrow_exception( worker_exception );
+			}
+			if( caller_exception ) {
+				std::rethrow_exception( caller_exception );
+			}
+			return { read_result, write_result };
+		}
+	} // namespace util_details
+
+	/// @brief Read blocks from reader, split them at the last delimiter and
+	/// call func for each record of a block on worker threads.  Records
+	/// split across blocks are stitched back together.  func is called
+	/// concurrently and must be safe to do so, with each record, without its
+	/// delimiter, and a Writer<std::string> for its output.  The output of a
+	/// batch of records is written to writer, in input order unless
+	/// opts.order is unordered.  An exception thrown by func, reader or writer
+	/// is rethrown here once the workers have stopped
+	/// @param func Called as func( daw::string_view, Writer<std::string> & )
+	/// @return The bytes read, and written to writer
+	template<typename T, typename U, typename Func>
+	[[nodiscard]] CopyResult
+	for_each_record_parallel( Writer<T> &writer, Reader<U> &reader,
+	                          char delimiter, Func &&func,
+	                          record_options opts = record_options{ } ) {
+		return util_details::for_each_record_impl(
+		  reader, delimiter, func, opts, [&]( std::string const &output ) {
+			  if( output.empty( ) ) {
+				  return IOOpResult{ };
+			  }
+			  return writer.write( daw::string_view( output ) );
+		  } );
+	}
+
+	/// @brief Call func( daw::string_view ) for each record of reader, on
+	/// worker threads and in no particular order.  See the overload taking a
+	/// Writer
+	/// @return The bytes read
+	template<typename U, typename Func>
+	[[nodiscard]] IOOpResult
+	for_each_record_parallel( Reader<U> &reader, char delimiter, Func &&func,
+	                          record_options opts = record_options{ } ) {
+		opts.order = record_order::unordered;
+		return util_details::for_each_record_impl(
+		         reader, delimiter, func, opts,
+		         []( std::string const & ) { return IOOpResult{ }; } )
+		  .read_result;
+	}
+} // namespace daw::io::util
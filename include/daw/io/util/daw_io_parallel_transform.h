@@ -0,0 +1,215 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_algorithms.h"
+
+#include <daw/daw_string_view.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace daw::io::util {
+	/// @brief How parallel_transform splits its input between threads
+	struct parallel_options {
+		/// The number of worker threads, 0 for std::thread::hardware_concurrency
+		std::size_t thread_count = 0;
+		/// The bytes transformed at a time by a worker.  Small enough that a
+		/// chunk stays in cache between being transformed and written
+		std::size_t chunk_size = 256U * 1024U;
+	};
+
+	namespace util_details {
+		/// @brief The output buffer of a chunk, reused by every window_size'th
+		/// chunk
+		struct parallel_slot {
+			std::span<std::byte> buffer;
+			std::size_t size = 0;
+			/// The chunk whose output is in buffer, set once it is transformed
+			alignas( 64 ) std::atomic<std::size_t> ready =
+			  std::numeric_limits<std::size_t>::max( );
+		};
+
+		/// @brief Transform input with thread_count workers while the calling
+		/// thread writes the chunks in order.  Workers take the next chunk from a
+		/// shared counter, so a slow chunk never holds up idle threads, and stay
+		/// at most a window of chunks ahead of the writer so memory use is
+		/// bounded by the window, not the input
+		template<typename T, typename Func>
+		[[nodiscard]] CopyResult
+		parallel_transform_impl( Writer<T> &writer,
+		                         std::span<std::byte const> input, Func &func,
+		                         parallel_options opts ) {
+			auto const chunk_size = std::max( opts.chunk_size, std::size_t{ 1 } );
+			auto const chunk_count = ( input.size( ) + chunk_size - 1 ) / chunk_size;
+			auto thread_count = opts.thread_count;
+			if( thread_count == 0 ) {
+				thread_count =
+				  std::max( std::size_t{ std::thread::hardware_concurrency( ) },
+				            std::size_t{ 1 } );
+			}
+			thread_count = std::min( thread_count, chunk_count );
+			auto const window_size = std::max( thread_count * 2U, std::size_t{ 1 } );
+			auto memory = std::make_unique_for_overwrite<std::byte[]>(
+			  std::min( window_size, chunk_count ) * chunk_size );
+			auto slots = std::make_unique<parallel_slot[]>( window_size );
+			for( std::size_t n = 0; n < std::min( window_size, chunk_count ); ++n ) {
+				slots[n].buffer =
+				  std::span<std::byte>( memory.get( ) + n * chunk_size, chunk_size );
+			}
+			auto next_chunk = std::atomic<std::size_t>( 0 );
+			auto written = std::atomic<std::size_t>( 0 );
+			auto stop = std::atomic<bool>( false );
+			auto failed = std::atomic<bool>( false );
+			std::exception_ptr worker_exception = nullptr;
+
+			auto const work = [&] {
+				while( true ) {
+					auto const idx = next_chunk.fetch_add( 1, std::memory_order_relaxed );
+					if( idx >= chunk_count ) {
+						return;
+					}
+					auto done = written.load( std::memory_order_acquire );
+					while( idx >= done + window_size ) {
+						written.wait( done, std::memory_order_acquire );
+						done = written.load( std::memory_order_acquire );
+					}
+					parallel_slot &slot = slots[idx % window_size];
+					auto const first = idx * chunk_size;
+					auto const in = input.subspan(
+					  first, std::min( chunk_size, input.size( ) - first ) );
+					slot.size = in.size( );
+					// After a failure the remaining chunks are published untouched so
+					// that the writer, which waits on each in turn, can finish
+					if( not stop.load( std::memory_order_acquire ) ) {
+						try {
+							transform_into( func, in.data( ), slot.buffer.data( ),
+							                in.size( ), first );
+						} catch( ... ) {
+							if( not failed.exchange( true ) ) {
+								worker_exception = std::current_exception( );
+							}
+							stop.store( true, std::memory_order_release );
+						}
+					}
+					slot.ready.store( idx, std::memory_order_release );
+					slot.ready.notify_one( );
+				}
+			};
+
+			auto read_result = IOOpResult{ IOOpStatus::Eof, 0 };
+			auto write_result = IOOpResult{ };
+			std::exception_ptr writer_exception = nullptr;
+			{
+				auto workers = std::vector<std::jthread>( );
+				workers.reserve( thread_count );
+				for( std::size_t n = 0; n < thread_count; ++n ) {
+					try {
+						workers.emplace_back( work );
+					} catch( std::system_error const & ) {
+						// The workers that did start take every chunk between them.
+						// Without any, nothing is waiting on written yet
+						if( workers.empty( ) ) {
+							throw;
+						}
+						break;
+					}
+				}
+				for( std::size_t idx = 0; idx < chunk_count; ++idx ) {
+					parallel_slot &slot = slots[idx % window_size];
+					auto ready = slot.ready.load( std::memory_order_acquire );
+					while( ready != idx ) {
+						slot.ready.wait( ready, std::memory_order_acquire );
+						ready = slot.ready.load( std::memory_order_acquire );
+					}
+					if( not stop.load( std::memory_order_acquire ) ) {
+						try {
+							auto const wr = writer.write(
+							  std::span<std::byte const>( slot.buffer.first( slot.size ) ) );
+							write_result.status = wr.status;
+							write_result.count += wr.count;
+						} catch( ... ) {
+							writer_exception = std::current_exception( );
+							write_result.status = IOOpStatus::Error;
+						}
+						if( write_result.status == IOOpStatus::Ok ) {
+							read_result.count += slot.size;
+						} else {
+							stop.store( true, std::memory_order_release );
+						}
+					}
+					written.store( idx + 1, std::memory_order_release );
+					written.notify_all( );
+				}
+			}
+			if( worker_exception ) {
+				std::rethrow_exception( worker_exception );
+			}
+			if( writer_exception ) {
+				std::rethrow_exception( writer_exception );
+			}
+			if( read_result.count < input.size( ) ) {
+				read_result.status = IOOpStatus::Ok;
+			}
+			return { read_result, write_result };
+		}
+	} // namespace util_details
+
+	/// @brief Apply func to each byte of input and write the results, in order,
+	/// to writer.  The input is split into chunks that are transformed on
+	/// several threads while the calling thread writes them.  func is called
+	/// concurrently and must be safe to do so.  An exception thrown by func or
+	/// the writer is rethrown here
+	/// @param func Called with, and returning, each std::byte
+	/// @return The read result is Eof with the bytes written when all of input
+	/// was written, otherwise Ok with the bytes written
+	template<typename T, typename Func>
+	[[nodiscard]] CopyResult
+	parallel_transform( Writer<T> &writer, std::span<std::byte const> input,
+	                    Func &&func,
+	                    parallel_options opts = parallel_options{ } ) {
+		return util_details::parallel_transform_impl( writer, input, func, opts );
+	}
+
+	template<typename T, typename Func>
+	[[nodiscard]] CopyResult
+	parallel_transform( Writer<T> &writer, daw::string_view input, Func &&func,
+	                    parallel_options opts = parallel_options{ } ) {
+		auto const bytes =
+		  std::as_bytes( std::span<char const>( input.data( ), input.size( ) ) );
+		return util_details::parallel_transform_impl( writer, bytes, func, opts );
+	}
+
+	/// @brief Transform from reader into writer until Eof.  Sources already in
+	/// memory, those with a borrow hook like mmap_reader, are transformed in
+	/// parallel without copying and the reader is advanced to the end.  Other
+	/// sources are transformed on the calling thread as with transform
+	template<typename T, typename U, typename Func>
+	[[nodiscard]] CopyResult
+	parallel_transform( Writer<T> &writer, Reader<U> &reader, Func &&func,
+	                    parallel_options opts = parallel_options{ } ) {
+		if constexpr( has_borrow_v<U> ) {
+			auto const input =
+			  ReadableInput<U>::borrow( reader.readable( ), util_details::until_eof );
+			return parallel_transform( writer, input, func, opts );
+		} else {
+			(void)opts;
+			return transform( writer, reader, func );
+		}
+	}
+} // namespace daw::io::util
@@ -0,0 +1,204 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_read_write
+//
+
+#pragma once
+
+#include "daw_io_algorithms.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace daw::io::util {
+	/// @brief How pipelined_copy/pipelined_transform buffer data between the
+	/// reading and writing threads
+	struct pipeline_options {
+		/// The number of buffers in flight, at least 2
+		std::size_t buffer_count = 4U;
+		std::size_t buffer_size = 256U * 1024U;
+	};
+
+	namespace util_details {
+		/// @brief A filled buffer handed from the reading thread to the writer
+		struct pipeline_slot {
+			std::span<std::byte> buffer;
+			IOOpResult read_result;
+			/// The reader will not publish any more slots
+			bool last = false;
+		};
+
+		/// @brief A fixed ring of slots with a single producer, the reading
+		/// thread, and a single consumer, the writing thread.  Each side only
+		/// writes its own index and blocks with atomic wait when the ring is
+		/// full or empty
+		class pipeline_ring {
+			std::unique_ptr<std::byte[]> m_memory;
+			std::vector<pipeline_slot> m_slots;
+			alignas( 64 ) std::atomic<std::size_t> m_head = 0;
+			alignas( 64 ) std::atomic<std::size_t> m_tail = 0;
+
+		public:
+			explicit pipeline_ring( pipeline_options opts )
+			  : m_memory( std::make_unique_for_overwrite<std::byte[]>(
+			      opts.buffer_count * opts.buffer_size ) )
+			  , m_slots( opts.buffer_count ) {
+				assert( opts.buffer_count >= 2 and opts.buffer_size > 0 );
+				for( std::size_t n = 0; n < opts.buffer_count; ++n ) {
+					m_slots[n].buffer = std::span<std::byte>(
+					  m_memory.get( ) + n * opts.buffer_size, opts.buffer_size );
+				}
+			}
+
+			/// @brief Wait until a slot is free and return it for filling
+			[[nodiscard]] pipeline_slot &acquire_empty( ) {
+				auto const head = m_head.load( std::memory_order_relaxed );
+				auto tail = m_tail.load( std::memory_order_acquire );
+				while( head - tail == m_slots.size( ) ) {
+					m_tail.wait( tail, std::memory_order_acquire );
+					tail = m_tail.load( std::memory_order_acquire );
+				}
+				return m_slots[head % m_slots.size( )];
+			}
+
+			/// @brief Hand the slot from acquire_empty to the consumer
+			void publish( ) {
+				m_head.fetch_add( 1, std::memory_order_release );
+				m_head.notify_one( );
+			}
+
+			/// @brief Wait until a slot has been published and return it
+			[[nodiscard]] pipeline_slot &acquire_filled( ) {
+				auto const tail = m_tail.load( std::memory_order_relaxed );
+				auto head = m_head.load( std::memory_order_acquire );
+				while( head == tail ) {
+					m_head.wait( head, std::memory_order_acquire );
+					head = m_head.load( std::memory_order_acquire );
+				}
+				return m_slots[tail % m_slots.size( )];
+			}
+
+			/// @brief Return the slot from acquire_filled to the producer
+			void release( ) {
+				m_tail.fetch_add( 1, std::memory_order_release );
+				m_tail.notify_one( );
+			}
+		};
+
+		template<typename T, typename U, typename Func>
+		[[nodiscard]] CopyResult
+		pipelined_transform_impl( Writer<T> &writer, Reader<U> &reader,
+		                          Func &func, pipeline_options opts ) {
+			opts.buffer_count = std::max( opts.buffer_count, std::size_t{ 2 } );
+			opts.buffer_size = std::max( opts.buffer_size, std::size_t{ 1 } );
+			auto ring = pipeline_ring( opts );
+			auto stop = std::atomic<bool>( false );
+			std::exception_ptr reader_exception = nullptr;
+
+			auto read_thread = std::jthread( [&] {
+				std::uint64_t position = 0;
+				while( true ) {
+					pipeline_slot &slot = ring.acquire_empty( );
+					if( stop.load( std::memory_order_acquire ) ) {
+						slot.read_result = { IOOpStatus::Ok, 0 };
+						slot.last = true;
+						ring.publish( );
+						return;
+					}
+					try {
+						slot.read_result = reader.read( slot.buffer );
+						if constexpr( not std::is_same_v<copy_op,
+						                                 std::remove_cvref_t<Func>> ) {
+							transform_into( func, slot.buffer.data( ), slot.buffer.data( ),
+							                slot.read_result.count, position );
+						}
+						position += slot.read_result.count;
+					} catch( ... ) {
+						reader_exception = std::current_exception( );
+						slot.read_result = { IOOpStatus::Error, 0 };
+					}
+					slot.last = slot.read_result.status != IOOpStatus::Ok;
+					ring.publish( );
+					if( slot.last ) {
+						return;
+					}
+				}
+			} );
+
+			auto read_result = IOOpResult{ };
+			auto write_result = IOOpResult{ };
+			std::exception_ptr writer_exception = nullptr;
+			bool last = false;
+			while( not last ) {
+				pipeline_slot &slot = ring.acquire_filled( );
+				last = slot.last;
+				if( not stop.load( std::memory_order_relaxed ) ) {
+					read_result.status = slot.read_result.status;
+					read_result.count += slot.read_result.count;
+					try {
+						if( slot.read_result.count > 0 ) {
+							auto const wr = writer.write( std::span<std::byte const>(
+							  slot.buffer.first( slot.read_result.count ) ) );
+							write_result.status = wr.status;
+							write_result.count += wr.count;
+						}
+					} catch( ... ) {
+						writer_exception = std::current_exception( );
+						write_result.status = IOOpStatus::Error;
+					}
+					if( write_result.status != IOOpStatus::Ok ) {
+						// Keep draining so the reader sees stop and is not left waiting
+						// on a full ring
+						stop.store( true, std::memory_order_release );
+					}
+				}
+				ring.release( );
+			}
+			read_thread.join( );
+			if( reader_exception ) {
+				std::rethrow_exception( reader_exception );
+			}
+			if( writer_exception ) {
+				std::rethrow_exception( writer_exception );
+			}
+			return { read_result, write_result };
+		}
+	} // namespace util_details
+
+	/// @brief Transform from reader to writer until Eof or an error with the
+	/// reading, and func, on a separate thread.  Filled buffers are handed to
+	/// the calling thread, which writes them, so the latency of reading
+	/// overlaps that of writing.  reader must not be used elsewhere until this
+	/// returns.  An exception thrown by reading or func is rethrown here
+	/// @param func Called with, and returning, each std::byte
+	template<typename T, typename U, typename Func>
+	[[nodiscard]] CopyResult
+	pipelined_transform( Writer<T> &writer, Reader<U> &reader, Func &&func,
+	                     pipeline_options opts = pipeline_options{ } ) {
+		return util_details::pipelined_transform_impl( writer, reader, func,
+		                                               opts );
+	}
+
+	/// @brief Copy from reader to writer until Eof or an error, reading on a
+	/// separate thread.  See pipelined_transform
+	template<typename T, typename U>
+	[[nodiscard]] CopyResult
+	pipelined_copy( Writer<T> &writer, Reader<U> &reader,
+	                pipeline_options opts = pipeline_options{ } ) {
+		auto op = util_details::copy_op{ };
+		return util_details::pipelined_transform_impl( writer, reader, op, opts );
+	}
+} // namespace daw::io::util
@@ -10,11 +10,122 @@
 #if not defined( _MSC_VER )
 #include <daw/io/daw_read_write_fd.h>
 #endif
+#include <daw/io/daw_read_stream.h>
 #include <daw/io/daw_type_writers.h>
 #include <daw/io/daw_write_stream.h>
+#include <daw/io/util/daw_io_byte_kernels.h>
+#include <daw/io/util/daw_io_parallel_records.h>
+#include <daw/io/util/daw_io_parallel_transform.h>
+#include <daw/io/util/daw_io_pipelined_copy.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <new>
+#include <span>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Writer, Reader and the proxies are handles, cheap to construct and copy
+static_assert( std::is_trivially_copyable_v<daw::io::Writer<std::string>> );
+static_assert( sizeof( daw::io::Writer<std::string> ) == sizeof( void * ) );
+static_assert(
+  std::is_trivially_copyable_v<daw::io::Reader<daw::string_view>> );
+static_assert( sizeof( daw::io::Reader<daw::string_view> ) ==
+               sizeof( void * ) );
+static_assert( std::is_trivially_copyable_v<daw::io::WriteProxy> );
+static_assert( std::is_trivially_copyable_v<daw::io::ReadProxy> );
+
+namespace {
+	/// Counts operator new, to check that formatting does not allocate
+	std::atomic<std::size_t> allocation_count = 0;
+} // namespace
+
+void *operator new( std::size_t size ) {
+	++allocation_count;
+	if( void *ptr = std::malloc( size == 0 ? 1 : size ) ) {
+		return ptr;
+	}
+	throw std::bad_alloc( );
+}
+
+void operator delete( void *ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete( void *ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+void *operator new[]( std::size_t size ) {
+	return operator new( size );
+}
+
+void operator delete[]( void *ptr ) noexcept {
+	std::free( ptr );
+}
+
+void operator delete[]( void *ptr, std::size_t ) noexcept {
+	std::free( ptr );
+}
+
+namespace {
+	/// A growable sink that can reserve but writes one piece at a time, so
+	/// that only reserving keeps it from growing more than once
+	struct piecewise_string {
+		std::string value;
+	};
+} // namespace
+
+namespace daw::io {
+	template<>
+	struct WritableOutput<piecewise_string> {
+		using string_output = WritableOutput<std::string>;
+
+		static IOOpResult write( piecewise_string &s, daw::string_view sv ) {
+			return string_output::write( s.value, sv );
+		}
+
+		static IOOpResult write( piecewise_string &s,
+		                         std::initializer_list<daw::string_view> svs ) {
+			return string_output::write( s.value, svs );
+		}
+
+		static IOOpResult write( piecewise_string &s,
+		                         std::span<std::byte const> sp ) {
+			return string_output::write( s.value, sp );
+		}
+
+		static IOOpResult
+		write( piecewise_string &s,
+		       std::initializer_list<std::span<std::byte const>> sps ) {
+			return string_output::write( s.value, sps );
+		}
+
+		static void reserve( piecewise_string &s, std::size_t n ) {
+			string_output::reserve( s.value, n );
+		}
+
+		static IOOpResult put( piecewise_string &s, char c ) {
+			return string_output::put( s.value, c );
+		}
+
+		static IOOpResult put( piecewise_string &s, std::byte b ) {
+			return string_output::put( s.value, b );
+		}
+	};
+} // namespace daw::io
 
 int main( int, char **argv ) {
 	{
@@ -23,9 +134,535 @@ int main( int, char **argv ) {
 		(void)wp.write( "ostream start\n" );
 		auto wo = daw::io::write_ostream( wp );
 		wo.write( "Hello\n", 6 );
-		wo << "Hello World  " << 5555 << " WHAT!\n\n";
+		wo << "Hello World  " << 5555 << " WHAT!\n\n" << std::flush;
 		(void)wp.write( "ostream done\n" );
 	}
+	{
+		// Borrowing sources are the get area, nothing is copied
+		auto const text = std::string_view( "12 34 word\nsecond line\n" );
+		auto text_sv = daw::string_view( text.data( ), text.size( ) );
+		auto rsb = daw::io::read_streambuf( text_sv );
+		auto const text_size = static_cast<std::streamsize>( text.size( ) );
+		if( rsb.sgetc( ) != '1' or rsb.in_avail( ) != text_size ) {
+			std::terminate( );
+		}
+		auto parse = []( std::istream &is ) {
+			int a = 0;
+			int b = 0;
+			auto word = std::string( );
+			auto line = std::string( );
+			is >> a >> b >> word;
+			is.ignore( );
+			std::getline( is, line );
+			return a == 12 and b == 34 and word == "word" and
+			       line == "second line" and is.get( ) == EOF and is.eof( );
+		};
+		text_sv = daw::string_view( text.data( ), text.size( ) );
+		auto ris = daw::io::read_istream( text_sv );
+		if( not parse( ris ) ) {
+			std::terminate( );
+		}
+		// Other sources refill a block buffer, smaller than the tokens here
+		auto iss = std::istringstream( std::string( text ) );
+		auto &is_ref = static_cast<std::istream &>( iss );
+		auto bis = daw::io::read_istream( is_ref, 3 );
+		if( not parse( bis ) ) {
+			std::terminate( );
+		}
+		// Large reads skip the buffer
+		auto big = std::string( 10000, 'b' );
+		big += "end";
+		auto big_iss = std::istringstream( big );
+		auto &big_ref = static_cast<std::istream &>( big_iss );
+		auto big_is = daw::io::read_istream( big_ref, 16 );
+		auto big_out = std::string( big.size( ), '\0' );
+		big_is.read( big_out.data( ), 5 );
+		big_is.read( big_out.data( ) + 5,
+		             static_cast<std::streamsize>( big.size( ) - 5 ) );
+		if( big_is.gcount( ) != static_cast<std::streamsize>( big.size( ) - 5 ) or
+		    big_out != big or big_is.get( ) != EOF ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Insertions stay in the put area until it fills or is flushed
+		auto str = std::string( );
+		{
+			auto wo = daw::io::write_ostream( str );
+			wo << 'a' << 42 << "bc";
+			if( not str.empty( ) ) {
+				std::terminate( );
+			}
+			wo << std::flush;
+			if( str != "a42bc" ) {
+				std::terminate( );
+			}
+			wo << 'x';
+		}
+		if( str != "a42bcx" ) {
+			std::terminate( );
+		}
+		// A caller supplied put area, smaller than some of the insertions
+		str.clear( );
+		char put_area[8];
+		auto expected = std::string( );
+		{
+			auto wo = daw::io::write_ostream( daw::io::WriteProxy( str ),
+			                                  std::span<char>( put_area ) );
+			for( int n = 0; n < 100; ++n ) {
+				wo << n << ( n % 10 == 0 ? " a longer insertion " : "," );
+				expected += std::to_string( n );
+				expected += n % 10 == 0 ? " a longer insertion " : ",";
+			}
+		}
+		if( str != expected ) {
+			std::terminate( );
+		}
+		// Unbuffered writes each insertion through
+		str.clear( );
+		auto wo = daw::io::write_ostream( str, 0 );
+		wo << 'a' << 1;
+		if( str != "a1" ) {
+			std::terminate( );
+		}
+	}
+	{
+		auto str = std::string( );
+		{
+			auto bw = daw::io::BufferedWriter<std::string, 16>( str );
+			auto w = daw::io::Writer( bw );
+			(void)w.write( "Hello" );
+			(void)w.put( ' ' );
+			if( not str.empty( ) or bw.size( ) != 6 ) {
+				std::terminate( );
+			}
+			(void)w.write( { "World", ", this is buffered" } );
+			if( str != "Hello World, this is buffered" or bw.size( ) != 0 ) {
+				std::terminate( );
+			}
+			(void)w.write( "abc" );
+		}
+		if( str != "Hello World, this is bufferedabc" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		auto bw =
+		  daw::io::BufferedWriter( str, daw::io::BufferFlushPolicy::OnNewline );
+		(void)bw.write( "line" );
+		(void)bw.put( '\n' );
+		if( str != "line\n" ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Integers are formatted in place for sinks that support prepare/commit
+		// and through a stack buffer otherwise
+		auto str = std::string( "x" );
+		auto sw = daw::io::Writer( str );
+		(void)daw::io::type_writer::write_all(
+		  sw, 0, ' ', 12345U, ' ', -9876, ' ',
+		  std::numeric_limits<long long>::min( ), ' ',
+		  std::numeric_limits<unsigned long long>::max( ) );
+		if( str != "x0 12345 -9876 -9223372036854775808 18446744073709551615" ) {
+			std::terminate( );
+		}
+		char ibuff[8]{ };
+		auto isp = std::span<char>( ibuff );
+		auto ip = daw::io::WriteProxy( isp );
+		(void)daw::io::type_writer::type_writer( ip, -1234567 );
+		if( std::string_view( ibuff, 8 ) != std::string_view( "-1234567", 8 ) or
+		    not isp.empty( ) ) {
+			std::terminate( );
+		}
+		if( daw::io::type_writer::type_writer( ip, 1 ).status ==
+		    daw::io::IOOpStatus::Ok ) {
+			std::terminate( );
+		}
+		auto oss = std::ostringstream( );
+		auto op = daw::io::WriteProxy( static_cast<std::ostream &>( oss ) );
+		(void)daw::io::type_writer::type_writer( op, 4242U );
+		if( oss.str( ) != "4242" ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Strings and numbers are gathered into one write, other arguments and
+		// escaped braces are written piece by piece
+		namespace tw = daw::io::type_writer;
+		auto str = std::string( );
+		auto sw = daw::io::Writer( str );
+		auto const pr = tw::print( sw, "a{}b{ }c{}{}", 1, "x", 'y', 2.5 );
+		if( str != "a1bxcy2.5" or pr.count != str.size( ) ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::print( sw, "Hello {{{} {} World! x{y{}", 55U, 42, -1 );
+		if( str != "Hello {55 42 World! x{y-1" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		auto const pi = std::string( "pi" );
+		auto const pr2 =
+		  tw::print( sw, "{}={} {{}}", pi, tw::fixed( 3.14159, 2 ) );
+		if( str != "pi=3.14 {}}" or pr2.count != str.size( ) ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::print( sw, "no arguments" );
+		if( str != "no arguments" ) {
+			std::terminate( );
+		}
+		// In memory sinks with prepare are written piece by piece
+		str.clear( );
+		{
+			auto bw = daw::io::BufferedWriter<std::string, 16>( str );
+			(void)tw::print( bw, "a{}b{}c", 12345, "a longer argument" );
+		}
+		if( str != "a12345ba longer argumentc" ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Format specs, the expected text is what std::format produces
+		namespace tw = daw::io::type_writer;
+		auto str = std::string( );
+		auto sw = daw::io::Writer( str );
+		auto const pr = tw::print( sw, "[{:>6}|{:<4}|{:*^7}|{:08x}|{:#b}]", 42,
+		                           "ab", "mid", 255U, 5 );
+		if( str != "[    42|ab  |**mid**|000000ff|0b101]" or
+		    pr.count != str.size( ) ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::print( sw, "{:+} {: d} {:#06X} {:#o} {:+08d} {:c} {:d}", 7,
+		                 3, 0xbeefU, 8, -42, 65, 'A' );
+		if( str != "+7  3 0XBEEF 010 -0000042 A 65" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::print( sw, "{:.3f} {:10.2e} {:<8.1f}| {:+g} {:08.2f} {:.2}",
+		                 3.14159, 12345.678, -0.25, 1.5, -2.5, "xyz" );
+		if( str != "3.142   1.23e+04 -0.2    | +1.5 -0002.50 xy" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::print( sw, "{:E} {:F} {:06}", 1e-5, 0.5,
+		                 std::numeric_limits<double>::infinity( ) );
+		if( str != "1.000000E-05 0.500000    inf" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		// The request's examples format without allocating
+		str.clear( );
+		str.reserve( 1024 );
+		auto const allocations = allocation_count.load( );
+		(void)tw::print( sw, "{:>10} {:08x} {:.3f} {:#b}", 42, 255U, 3.14159,
+		                 5 );
+		(void)tw::print( sw, "{:f} {:10.2e} {:F}", -2.5, 1e300, 1e300 );
+		if( allocation_count.load( ) != allocations or
+		    str.substr( 0, 37 ) != "        42 000000ff 3.142 0b101-2.500" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		// Fields wider than the stack buffer are written in pieces
+		auto const pr2 = tw::print( sw, "{:->300}", "end" );
+		if( str != std::string( 297, '-' ) + "end" or pr2.count != 300 ) {
+			std::terminate( );
+		}
+	}
+	{
+		// formatted_size is exact for strings, characters and integers, so
+		// strings are reserved once with the final size
+		namespace tw = daw::io::type_writer;
+		auto const s = std::string( 40, 's' );
+		if( tw::formatted_size( "ab", 'c', -123, 0U, true, s ) != 49 or
+		    tw::formatted_size( 1.5 ) < 3 or
+		    tw::formatted_size( tw::fixed( 1e300, 2 ) ) < 304 ) {
+			std::terminate( );
+		}
+		static_assert( daw::io::has_reserve_v<std::string> );
+		static_assert( not daw::io::has_reserve_v<std::ostream> );
+		auto str = std::string( );
+		auto wp = daw::io::WriteProxy( str );
+		if( not wp.can_reserve( ) ) {
+			std::terminate( );
+		}
+		wp.reserve( 1000 );
+		if( str.capacity( ) < 1000 or not str.empty( ) ) {
+			std::terminate( );
+		}
+		auto oss = std::ostringstream( );
+		if( daw::io::WriteProxy( static_cast<std::ostream &>( oss ) )
+		      .can_reserve( ) ) {
+			std::terminate( );
+		}
+		// Appending piece by piece would reallocate several times, reserving
+		// allocates once
+		str.clear( );
+		str.shrink_to_fit( );
+		auto sw = daw::io::Writer( str );
+		auto const expected = s + " -42 " + s;
+		auto allocations = allocation_count.load( );
+		(void)tw::write_all( sw, s, ' ', -42, ' ', s );
+		if( allocation_count.load( ) != allocations + 1 or str != expected ) {
+			std::terminate( );
+		}
+		str.clear( );
+		str.shrink_to_fit( );
+		auto const expected_print = "{" + s + "}}       -7 0xff ab|  z  ";
+		allocations = allocation_count.load( );
+		auto const pr = tw::print( sw, "{{{}}} {:>8} {:#x} {:.2}|{:^5}", s, -7,
+		                           255, "abc", 'z' );
+		if( allocation_count.load( ) != allocations + 1 or
+		    str != expected_print or pr.count != str.size( ) ) {
+			std::terminate( );
+		}		// Through a WriteProxy, which gathers a print without specs whatever
+		// it wraps
+		str.clear( );
+		str.shrink_to_fit( );
+		auto proxy = daw::io::WriteProxy( str );
+		allocations = allocation_count.load( );
+		auto const ppr = tw::print( proxy, "{} {} {}", s, -42, s );
+		if( allocation_count.load( ) != allocations + 1 or str != expected or
+		    ppr.count != str.size( ) ) {
+			std::terminate( );
+		}
+		auto pw = piecewise_string( );
+		auto pw_proxy = daw::io::WriteProxy( pw );
+		allocations = allocation_count.load( );
+		(void)tw::print( pw_proxy, "{} {} {}", s, -42, s );
+		if( allocation_count.load( ) != allocations + 1 or pw.value != expected ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Every width around each power of 10, where the digit count changes
+		auto const check_width = []( auto tag ) {
+			using int_t = decltype( tag );
+			using limits = std::numeric_limits<int_t>;
+			auto str = std::string( );
+			auto sw = daw::io::Writer( str );
+			auto const check_value = [&]( int_t v ) {
+				char expected[32];
+				auto const r = std::to_chars( expected, expected + 32, v );
+				str.clear( );
+				(void)daw::io::type_writer::type_writer( sw, v );
+				if( str != std::string_view( expected, r.ptr ) ) {
+					std::terminate( );
+				}
+			};
+			check_value( limits::min( ) );
+			check_value( limits::max( ) );
+			for( int_t p = 1;; p = static_cast<int_t>( p * 10 ) ) {
+				for( int d = -1; d <= 1; ++d ) {
+					check_value( static_cast<int_t>( p + d ) );
+					if constexpr( limits::is_signed ) {
+						check_value( static_cast<int_t>( -p - d ) );
+					}
+				}
+				if( p > limits::max( ) / 10 ) {
+					break;
+				}
+			}
+		};
+		check_width( std::int8_t{ } );
+		check_width( std::uint8_t{ } );
+		check_width( std::int16_t{ } );
+		check_width( std::uint16_t{ } );
+		check_width( std::int32_t{ } );
+		check_width( std::uint32_t{ } );
+		check_width( std::int64_t{ } );
+		check_width( std::uint64_t{ } );
+	}
+	{
+		// The shortest representation that reads back as the same value
+		namespace tw = daw::io::type_writer;
+		auto str = std::string( );
+		auto sw = daw::io::Writer( str );
+		(void)tw::write_all( sw, 0.1, ' ', -1.5, ' ', 1e300, ' ', 0.3F, ' ',
+		                     std::numeric_limits<double>::denorm_min( ), ' ',
+		                     std::numeric_limits<double>::infinity( ) );
+		if( str != "0.1 -1.5 1e+300 0.3 5e-324 inf" ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::write_all( sw, tw::fixed( 3.14159, 2 ), ' ',
+		                     tw::scientific( 1234.5, 2 ), ' ',
+		                     tw::general( 0.0001234, 2 ), ' ', tw::fixed( 1e-5 ),
+		                     ' ', tw::scientific( 2.5F ) );
+		if( str != "3.14 1.23e+03 0.00012 0.00001 2.5e+00" ) {
+			std::terminate( );
+		}
+		// Values that need more than the small buffer
+		str.clear( );
+		(void)tw::type_writer( sw, tw::fixed( 1e300, 2 ) );
+		if( str.size( ) != 304 or not str.starts_with( "1000000000000000052504" ) or
+		    not str.ends_with( ".00" ) ) {
+			std::terminate( );
+		}
+		str.clear( );
+		(void)tw::type_writer( sw, tw::fixed( 0.5, 2000 ) );
+		if( str.size( ) != 2002 or not str.starts_with( "0.500" ) ) {
+			std::terminate( );
+		}
+		for( double d = 1.0 / 3.0; d < 1e30; d *= 7.77 ) {
+			str.clear( );
+			(void)tw::type_writer( sw, d );
+			if( std::strtod( str.c_str( ), nullptr ) != d ) {
+				std::terminate( );
+			}
+		}
+		static_assert( tw::has_type_writer_v<double> and
+		               tw::has_type_writer_v<tw::formatted_float<float>> );
+	}
+	{
+		// Small buffers so the reading thread fills the ring many times
+		auto const opts = daw::io::util::pipeline_options{ 3, 7 };
+		auto const src = std::string( 10000, 'a' );
+		auto src_sv = daw::string_view( src );
+		auto src_r = daw::io::Reader( src_sv );
+		auto dst = std::string( );
+		auto dst_w = daw::io::Writer( dst );
+		auto const pr = daw::io::util::pipelined_transform(
+		  dst_w, src_r,
+		  []( std::byte b ) {
+			  return static_cast<std::byte>( std::toupper( static_cast<char>( b ) ) );
+		  },
+		  opts );
+		if( pr.read_result.status != daw::io::IOOpStatus::Eof or
+		    pr.write_result.count != 10000 or dst != std::string( 10000, 'A' ) ) {
+			std::terminate( );
+		}
+		// A failing writer stops the reading thread
+		char small_dst[20];
+		auto small_sp = std::span<char>( small_dst );
+		auto small_w = daw::io::Writer( small_sp );
+		src_sv = daw::string_view( src );
+		auto const pr2 = daw::io::util::pipelined_copy( small_w, src_r, opts );
+		if( pr2.write_result.status == daw::io::IOOpStatus::Ok or
+		    pr2.write_result.count > 20 ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Small chunks so each worker handles many, in order
+		auto const opts = daw::io::util::parallel_options{ 4, 100 };
+		auto src = std::string( );
+		for( int n = 0; n < 10000; ++n ) {
+			src += static_cast<char>( 'a' + n % 26 );
+		}
+		auto expected = src;
+		for( auto &c : expected ) {
+			c = static_cast<char>( std::toupper( c ) );
+		}
+		auto const upper = []( std::byte b ) {
+			return static_cast<std::byte>( std::toupper( static_cast<char>( b ) ) );
+		};
+		auto dst = std::string( );
+		auto dst_w = daw::io::Writer( dst );
+		auto const pr =
+		  daw::io::util::parallel_transform( dst_w, daw::string_view( src ), upper,
+		                                     opts );
+		if( pr.read_result.status != daw::io::IOOpStatus::Eof or
+		    pr.write_result.count != src.size( ) or dst != expected ) {
+			std::terminate( );
+		}
+		// Readers that borrow are transformed in parallel too
+		dst.clear( );
+		auto src_sv = daw::string_view( src );
+		auto src_r = daw::io::Reader( src_sv );
+		auto const pr2 =
+		  daw::io::util::parallel_transform( dst_w, src_r, upper, opts );
+		if( pr2.read_result.status != daw::io::IOOpStatus::Eof or
+		    dst != expected ) {
+			std::terminate( );
+		}
+		// Others are transformed on the calling thread
+		dst.clear( );
+		auto src_iss = std::istringstream( src );
+		auto &src_is = static_cast<std::istream &>( src_iss );
+		auto is_r = daw::io::Reader( src_is );
+		(void)daw::io::util::parallel_transform( dst_w, is_r, upper, opts );
+		if( dst != expected ) {
+			std::terminate( );
+		}
+		// A failing writer stops the workers
+		char small_dst[250];
+		auto small_sp = std::span<char>( small_dst );
+		auto small_w = daw::io::Writer( small_sp );
+		auto const pr3 = daw::io::util::parallel_transform(
+		  small_w, daw::string_view( src ), upper, opts );
+		if( pr3.write_result.status == daw::io::IOOpStatus::Ok or
+		    pr3.read_result.status != daw::io::IOOpStatus::Ok or
+		    pr3.read_result.count != 200 ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Long enough for the vector loops, with a tail for the scalar one
+		auto src = std::string( );
+		for( int n = 0; n < 1001; ++n ) {
+			src += static_cast<char>( n % 128 );
+		}
+		auto const transformed = [&]( auto const &func ) {
+			auto sv = daw::string_view( src );
+			auto r = daw::io::Reader( sv );
+			auto result = std::string( );
+			auto w = daw::io::Writer( result );
+			// An odd buffer size so chunks do not line up with the vectors
+			(void)daw::io::util::transform_b<37>( w, r, func );
+			return result;
+		};
+		auto const expected = [&]( auto const &func ) {
+			auto result = src;
+			for( auto &c : result ) {
+				c = static_cast<char>( func( static_cast<unsigned char>( c ) ) );
+			}
+			return result;
+		};
+		if( transformed( daw::io::util::ascii_to_upper{ } ) !=
+		      expected( []( unsigned char c ) { return std::toupper( c ); } ) or
+		    transformed( daw::io::util::ascii_to_lower{ } ) !=
+		      expected( []( unsigned char c ) { return std::tolower( c ); } ) ) {
+			std::terminate( );
+		}
+		auto const rot13 = []( unsigned char c ) -> unsigned char {
+			if( std::isalpha( c ) ) {
+				auto const base = std::isupper( c ) ? 'A' : 'a';
+				return static_cast<unsigned char>( base + ( c - base + 13 ) % 26 );
+			}
+			return c;
+		};
+		auto const table =
+		  daw::io::util::translate_table::from( [&]( std::byte b ) {
+			  auto const c = std::to_integer<unsigned char>( b );
+			  return static_cast<std::byte>( rot13( c ) );
+		  } );
+		if( transformed( table ) != expected( rot13 ) or
+		    transformed( daw::io::util::replace_byte( 'a', '_' ) ) !=
+		      expected( []( unsigned char c ) { return c == 'a' ? '_' : c; } ) ) {
+			std::terminate( );
+		}
+		auto const key = std::array<std::byte, 4>{
+		  std::byte{ 0x12 }, std::byte{ 0x34 }, std::byte{ 0x56 },
+		  std::byte{ 0x78 } };
+		auto const masked = transformed( daw::io::util::xor_mask( key ) );
+		for( std::size_t n = 0; n < src.size( ); ++n ) {
+			if( static_cast<std::byte>( masked[n] ) !=
+			    ( static_cast<std::byte>( src[n] ) ^ key[n % 4] ) ) {
+				std::terminate( );
+			}
+		}
+		// The chunks of a parallel_transform are masked from their own offsets
+		auto unmasked = std::string( );
+		auto uw = daw::io::Writer( unmasked );
+		(void)daw::io::util::parallel_transform(
+		  uw, daw::string_view( masked ), daw::io::util::xor_mask( key ),
+		  daw::io::util::parallel_options{ 3, 33 } );
+		if( unmasked != src ) {
+			std::terminate( );
+		}
+	}
 	auto s = std::string( );
 	auto p = daw::io::WriteProxy( s );
 	if( p.write( argv[0] ).status != daw::io::IOOpStatus::Ok ) {
@@ -45,6 +682,231 @@ int main( int, char **argv ) {
 	               reinterpret_cast<char const *>( peek_result.buffer.data( ) ),
 	               peek_result.buffer.size( ) )
 	          << '\n';
+	{
+		// Peeking through a long stream keeps reusing the same buffer
+		auto const long_src = std::string( 100000, 'p' );
+		auto long_sv = daw::string_view( long_src );
+		auto lpr = daw::io::PeekableReader( daw::io::Reader( long_sv ), 64 );
+		std::size_t total = 0;
+		while( true ) {
+			auto const pr = lpr.peek( 17 );
+			if( pr.buffer.empty( ) ) {
+				break;
+			}
+			total += lpr.consume( 10 );
+			char c = 0;
+			if( lpr.get( c ).count == 1 ) {
+				++total;
+			}
+		}
+		if( total != long_src.size( ) or lpr.capacity( ) > 34 or
+		    lpr.peek( 1000 ).buffer.size( ) != 0 or lpr.max_peek_size( ) != 64 ) {
+			std::terminate( );
+		}
+		auto short_sv = daw::string_view( "peeked then read" );
+		auto spr = daw::io::PeekableReader( daw::io::Reader( short_sv ) );
+		(void)spr.peek( 7 );
+		char pbuff[32]{ };
+		auto const pr1 = spr.read( std::span<char>( pbuff ) );
+		auto const pr2 = spr.read( std::span<char>( pbuff + 7, 25 ) );
+		if( pr1.count != 7 or pr2.count != 9 or
+		    std::string_view( pbuff ) != "peeked then read" ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Length prefixed frames parsed in place
+		auto frames = std::string( );
+		for( int n = 0; n < 300; ++n ) {
+			auto const body = std::string( static_cast<std::size_t>( n ), 'f' );
+			frames += std::to_string( body.size( ) ) + '\n' + body + "skip";
+		}
+		auto frames_sv = daw::string_view( frames );
+		auto fpr = daw::io::PeekableReader( daw::io::Reader( frames_sv ) );
+		std::size_t frame_count = 0;
+		while( true ) {
+			auto const header = fpr.peek_until( '\n' );
+			if( header.buffer.empty( ) ) {
+				break;
+			}
+			auto const *header_first =
+			  reinterpret_cast<char const *>( header.buffer.data( ) );
+			auto const len =
+			  std::stoul( std::string( header_first, header.buffer.size( ) - 1 ) );
+			(void)fpr.consume( header.buffer.size( ) );
+			auto const body = fpr.read_view( len );
+			if( body.buffer.size( ) != len or
+			    std::any_of( body.buffer.begin( ), body.buffer.end( ),
+			                 []( std::byte b ) { return b != std::byte{ 'f' }; } ) or
+			    fpr.skip( 4 ).count != 4 ) {
+				std::terminate( );
+			}
+			++frame_count;
+		}
+		auto no_delim_sv = daw::string_view( "no delimiter" );
+		auto npr = daw::io::PeekableReader( daw::io::Reader( no_delim_sv ) );
+		auto const nr = npr.peek_until( '\n' );
+		if( frame_count != 300 or nr.io_result.status != daw::io::IOOpStatus::Eof or
+		    nr.buffer.size( ) != 12 ) {
+			std::terminate( );
+		}
+		// read_view returns the peeked bytes themselves
+		auto const peeked = npr.peek( 2 );
+		if( npr.read_view( 2 ).buffer.data( ) != peeked.buffer.data( ) or
+		    npr.skip( 100 ).count != 10 ) {
+			std::terminate( );
+		}
+	}
+	{
+		// A small block size so records span refills and grow the buffer
+		auto lines = std::string( );
+		auto expected_lines = std::vector<std::string>( );
+		for( int n = 0; n < 1000; ++n ) {
+			expected_lines.push_back(
+			  std::string( static_cast<std::size_t>( n % 50 ), 'l' ) +
+			  std::to_string( n ) );
+			lines += expected_lines.back( ) + ( n % 3 == 0 ? "\r\n" : "\n" );
+		}
+		lines += "no final newline";
+		expected_lines.emplace_back( "no final newline" );
+		auto lines_sv = daw::string_view( lines );
+		auto lr = daw::io::LineReader( daw::io::Reader( lines_sv ), 16 );
+		std::size_t line_count = 0;
+		while( auto const line = lr.next( ) ) {
+			if( line_count >= expected_lines.size( ) or
+			    *line != daw::string_view( expected_lines[line_count] ) ) {
+				std::terminate( );
+			}
+			++line_count;
+		}
+		if( line_count != expected_lines.size( ) or
+		    lr.status( ) != daw::io::IOOpStatus::Eof ) {
+			std::terminate( );
+		}
+		// Records after a peek, with an empty record between delimiters and
+		// none after the last.  The Eof the peek reached is kept
+		auto csv_sv = daw::string_view( "head|a||b" );
+		auto cpr = daw::io::PeekableReader( daw::io::Reader( csv_sv ) );
+		(void)cpr.consume( cpr.peek_until( '|' ).buffer.size( ) );
+		auto dr = daw::io::DelimitedReader( daw::io::Reader( cpr ), '|' );
+		auto records = std::string( );
+		while( auto const rec = dr.next( ) ) {
+			records += std::string( rec->data( ), rec->size( ) ) + ',';
+		}
+		if( records != "a,,b," or dr.status( ) != daw::io::IOOpStatus::Eof ) {
+			std::terminate( );
+		}
+	}
+	{
+		// Blocks far smaller than the records so most are stitched together
+		auto src = std::string( );
+		auto expected = std::string( );
+		long long expected_sum = 0;
+		for( int n = 0; n < 2000; ++n ) {
+			auto const num = std::to_string( n * 7 );
+			src += std::string( static_cast<std::size_t>( n % 40 ), ' ' ) + num;
+			src += '\n';
+			expected += num + ';';
+			expected_sum += n * 7;
+		}
+		auto opts = daw::io::util::record_options{ };
+		opts.thread_count = 4;
+		opts.block_size = 16;
+		auto const to_num = []( daw::string_view rec ) {
+			return std::stoll( std::string( rec.data( ), rec.size( ) ) );
+		};
+		auto dst = std::string( );
+		auto dst_w = daw::io::Writer( dst );
+		auto src_sv = daw::string_view( src );
+		auto src_r = daw::io::Reader( src_sv );
+		auto const fr = daw::io::util::for_each_record_parallel(
+		  dst_w, src_r, '\n',
+		  [&]( daw::string_view rec, daw::io::Writer<std::string> &out ) {
+			  (void)out.write( std::to_string( to_num( rec ) ) + ';' );
+		  },
+		  opts );
+		if( fr.read_result.status != daw::io::IOOpStatus::Eof or
+		    fr.read_result.count != src.size( ) or dst != expected ) {
+			std::terminate( );
+		}
+		// Unordered output has every record, in any order
+		auto const sorted_records = []( std::string const &str ) {
+			auto result = std::vector<std::string>( );
+			auto rest = std::string_view( str );
+			while( not rest.empty( ) ) {
+				auto const pos = rest.find( ';' );
+				result.emplace_back( rest.substr( 0, pos ) );
+				rest.remove_prefix( std::min( pos + 1, rest.size( ) ) );
+			}
+			std::sort( result.begin( ), result.end( ) );
+			return result;
+		};
+		dst.clear( );
+		src_sv = daw::string_view( src );
+		auto unordered_opts = opts;
+		unordered_opts.order = daw::io::util::record_order::unordered;
+		auto const ufr = daw::io::util::for_each_record_parallel(
+		  dst_w, src_r, '\n',
+		  [&]( daw::string_view rec, daw::io::Writer<std::string> &out ) {
+			  (void)out.write( std::to_string( to_num( rec ) ) + ';' );
+		  },
+		  unordered_opts );
+		if( ufr.read_result.status != daw::io::IOOpStatus::Eof or
+		    dst.size( ) != expected.size( ) or
+		    sorted_records( dst ) != sorted_records( expected ) ) {
+			std::terminate( );
+		}
+		// The writerless overload, where the last record needs no delimiter
+		src += "5";
+		auto sum = std::atomic<long long>( 0 );
+		auto record_count = std::atomic<std::size_t>( 0 );
+		src_sv = daw::string_view( src );
+		auto const ur = daw::io::util::for_each_record_parallel(
+		  src_r, '\n',
+		  [&]( daw::string_view rec ) {
+			  sum += to_num( rec );
+			  ++record_count;
+		  },
+		  opts );
+		if( ur.status != daw::io::IOOpStatus::Eof or record_count != 2001 or
+		    sum != expected_sum + 5 ) {
+			std::terminate( );
+		}
+		// An exception from func is rethrown on the calling thread
+		src_sv = daw::string_view( src );
+		bool caught = false;
+		try {
+			(void)daw::io::util::for_each_record_parallel(
+			  src_r, '\n',
+			  [&]( daw::string_view rec ) {
+				  if( to_num( rec ) == 700 ) {
+					  throw std::runtime_error( "bad record" );
+				  }
+			  },
+			  opts );
+		} catch( std::runtime_error const & ) { caught = true; }
+		if( not caught ) {
+			std::terminate( );
+		}		// As is one from the writer, after the workers have been joined
+		struct failing_buf : std::streambuf {};
+		auto fail_buf = failing_buf( );
+		auto fail_os = std::ostream( &fail_buf );
+		fail_os.exceptions( std::ios_base::badbit );
+		auto fail_w = daw::io::Writer( static_cast<std::ostream &>( fail_os ) );
+		src_sv = daw::string_view( src );
+		caught = false;
+		try {
+			(void)daw::io::util::for_each_record_parallel(
+			  fail_w, src_r, '\n',
+			  [&]( daw::string_view rec, daw::io::Writer<std::string> &out ) {
+				  (void)out.write( rec );
+			  },
+			  opts );
+		} catch( std::ios_base::failure const & ) { caught = true; }
+		if( not caught ) {
+			std::terminate( );
+		}
+	}
 	char buff[1024]{ };
 	auto sp = std::span( buff );
 	auto result = rp.read( sp );
@@ -58,7 +920,7 @@ int main( int, char **argv ) {
 	sp = std::span( buff );
 	sv = s;
 	auto rr = daw::io::Reader( sv );
-	result = rp.read( sp );
+	result = rr.read( std::span<char>( sp ) );
 	(void)result;
 	if( result.count != s.size( ) ) {
 		std::terminate( );
@@ -83,5 +945,332 @@ int main( int, char **argv ) {
 	daw::io::type_writer::type_writer( fdw, 3333U );
 	(void)daw::io::type_writer::write_all( fdw, "Hello ", 42, ' ', 55U, " World\n\n");
 	daw::io::type_writer::print( fdw, "Hello {{{} {} World!", 55U, 42 );
+	{
+		// Gathered into a single writev
+		int fds[2];
+		if( ::pipe( fds ) != 0 ) {
+			std::terminate( );
+		}
+		auto pipe_out = daw::io::fd_wrap_t( fds[1] );
+		auto pw = daw::io::Writer( pipe_out );
+		auto const pr = daw::io::type_writer::print( pw, "[{}|{}|{}|{}]", -12,
+		                                             "ab", 'c', 0.25 );
+		char pipe_buff[32]{ };
+		auto const rd = ::read( fds[0], pipe_buff, sizeof( pipe_buff ) );
+		::close( fds[0] );
+		::close( fds[1] );
+		if( pr.count != 15 or rd != 15 or
+		    std::string_view( pipe_buff ) != "[-12|ab|c|0.25]" ) {
+			std::terminate( );
+		}
+	}
+	{
+		// More buffers than are submitted per writev call
+		int fds[2];
+		if( ::pipe( fds ) != 0 ) {
+			std::terminate( );
+		}
+		auto parts = std::vector<daw::string_view>( 200, "ab" );
+		parts[7] = "";
+		auto pipe_out = daw::io::fd_wrap_t( fds[1] );
+		auto pw = daw::io::WriteProxy( pipe_out );
+		auto const wr = pw.write_vectored( parts );
+		if( wr.status != daw::io::IOOpStatus::Ok or wr.count != 398 ) {
+			std::terminate( );
+		}
+		::close( fds[1] );
+		char pbuff[512]{ };
+		auto const read_count = ::read( fds[0], pbuff, sizeof( pbuff ) );
+		::close( fds[0] );
+		if( read_count != 398 or pbuff[0] != 'a' or pbuff[397] != 'b' ) {
+			std::terminate( );
+		}
+		auto vstr = std::string( );
+		auto vw = daw::io::Writer( vstr );
+		(void)vw.write_vectored( std::span( parts.data( ), 3 ) );
+		if( vstr != "ababab" ) {
+			std::terminate( );
+		}
+	}
+	{
+		char tmp_name[] = "/tmp/daw_read_write_test_XXXXXX";
+		int const tmp_fd = ::mkstemp( tmp_name );
+		if( tmp_fd < 0 ) {
+			std::terminate( );
+		}
+		auto tmp_w = daw::io::fd_wrap_t( tmp_fd );
+		(void)daw::io::Writer( tmp_w ).write( "mapped file contents" );
+		auto mr = daw::io::mmap_reader( tmp_name );
+		::close( tmp_fd );
+		if( not mr.is_open( ) or mr.size( ) != 20 ) {
+			std::terminate( );
+		}
+		(void)mr.advise_sequential( );
+		(void)mr.advise_willneed( );
+		if( mr.borrow( 7 ) != daw::string_view( "mapped " ) ) {
+			std::terminate( );
+		}
+		char mbuff[64]{ };
+		auto mrr = daw::io::Reader( mr );
+		auto const mres = mrr.read( std::span<char>( mbuff ) );
+		if( mres.status != daw::io::IOOpStatus::Eof or mres.count != 13 or
+		    std::string_view( mbuff ) != "file contents" ) {
+			std::terminate( );
+		}
+		mr.close( );
+		{
+			// Start small to force the mapping to grow
+			auto mw = daw::io::mmap_writer( tmp_name, 1 );
+			auto mww = daw::io::Writer( mw );
+			for( int n = 0; n < 10000; ++n ) {
+				(void)daw::io::type_writer::write_all( mww, n, '\n' );
+			}
+			if( not mw.is_open( ) or mw.capacity( ) < mw.size( ) ) {
+				std::terminate( );
+			}
+		}
+		mr = daw::io::mmap_reader( tmp_name );
+		auto expected = std::string( );
+		auto ew = daw::io::Writer( expected );
+		for( int n = 0; n < 10000; ++n ) {
+			(void)daw::io::type_writer::write_all( ew, n, '\n' );
+		}
+		if( mr.view( ) != daw::string_view( expected ) ) {
+			std::terminate( );
+		}
+		// The mapping is borrowed and transformed in parallel
+		auto copied = std::string( );
+		auto cw = daw::io::Writer( copied );
+		auto mrr2 = daw::io::Reader( mr );
+		auto const ptr = daw::io::util::parallel_transform(
+		  cw, mrr2, []( std::byte c ) { return c; },
+		  daw::io::util::parallel_options{ 3, 4096 } );
+		if( ptr.read_result.status != daw::io::IOOpStatus::Eof or
+		    copied != expected or mr.remaining( ) != 0 ) {
+			std::terminate( );
+		}
+		mr.close( );
+		{
+			// A write only fd cannot be mapped, the file must be left as it was
+			int const wo_fd = ::open( tmp_name, O_WRONLY | O_CLOEXEC );
+			if( wo_fd < 0 ) {
+				std::terminate( );
+			}
+			auto mw = daw::io::mmap_writer( daw::io::fd_wrap_t( wo_fd ) );
+			if( mw.is_open( ) ) {
+				std::terminate( );
+			}
+			(void)mw.close( );
+			::close( wo_fd );
+		}
+		mr = daw::io::mmap_reader( tmp_name );
+		if( mr.view( ) != daw::string_view( expected ) ) {
+			std::terminate( );
+		}
+		mr.close( );
+		::unlink( tmp_name );
+	}
+#if __has_include( <linux/io_uring.h> )
+	{
+		// Small buffers so that many reads and writes are in flight
+		auto const opts = daw::io::uring_options{ 4, 1000 };
+		char tmp_name[] = "/tmp/daw_read_write_uring_XXXXXX";
+		int const tmp_fd = ::mkstemp( tmp_name );
+		if( tmp_fd < 0 ) {
+			std::terminate( );
+		}
+		auto expected = std::string( );
+		auto ew = daw::io::Writer( expected );
+		{
+			auto uw = daw::io::uring_writer( tmp_fd, opts );
+			auto uww = daw::io::Writer( uw );
+			for( int n = 0; n < 10000; ++n ) {
+				(void)daw::io::type_writer::write_all( uww, n, '\n' );
+				(void)daw::io::type_writer::write_all( ew, n, '\n' );
+			}
+			auto const fr = uw.flush( );
+			if( fr.status != daw::io::IOOpStatus::Ok or
+			    fr.count != expected.size( ) ) {
+				std::terminate( );
+			}
+		}
+		if( ::lseek( tmp_fd, 0, SEEK_CUR ) !=
+		    static_cast<::off_t>( expected.size( ) ) ) {
+			std::terminate( );
+		}
+		::lseek( tmp_fd, 0, SEEK_SET );
+		auto actual = std::string( );
+		{
+			auto ur = daw::io::uring_reader( tmp_fd, opts );
+			auto urr = daw::io::Reader( ur );
+			auto aw = daw::io::Writer( actual );
+			auto const cr = daw::io::util::copy( aw, urr );
+			if( cr.read_result.status != daw::io::IOOpStatus::Eof or
+			    actual != expected ) {
+				std::terminate( );
+			}
+		}
+		::close( tmp_fd );
+		::unlink( tmp_name );
+		int fds[2];
+		if( ::pipe( fds ) != 0 ) {
+			std::terminate( );
+		}
+		{
+			auto uw = daw::io::uring_writer( fds[1], opts );
+			(void)daw::io::Writer( uw ).write( { "through ", "a pipe" } );
+		}
+		::close( fds[1] );
+		auto ur = daw::io::uring_reader( fds[0], opts );
+		char pbuff[32]{ };
+		auto const pr = daw::io::Reader( ur ).read( std::span<char>( pbuff ) );
+		if( pr.count != 14 or std::string_view( pbuff ) != "through a pipe" ) {
+			std::terminate( );
+		}
+		::close( fds[0] );
+	}
+#endif
+	{
+		// Each thread reads or writes its own range of one descriptor
+		char src_name[] = "/tmp/daw_read_write_src_XXXXXX";
+		char dst_name[] = "/tmp/daw_read_write_dst_XXXXXX";
+		int const src_fd = ::mkstemp( src_name );
+		int const dst_fd = ::mkstemp( dst_name );
+		if( src_fd < 0 or dst_fd < 0 ) {
+			std::terminate( );
+		}
+		auto expected = std::string( );
+		for( int n = 0; n < 10000; ++n ) {
+			expected += std::to_string( n );
+		}
+		auto src = daw::io::fd_wrap_t( src_fd );
+		(void)daw::io::Writer( src ).write( expected );
+		auto ranges = daw::io::split_file( src_fd, 4 );
+		if( ranges.size( ) != 4 or ranges.front( ).offset != 0 or
+		    ranges.back( ).end != expected.size( ) ) {
+			std::terminate( );
+		}
+		// Reading advances the offsets, keep the split for writing
+		auto const layout = ranges;
+		auto parts = std::vector<std::string>( ranges.size( ) );
+		{
+			auto threads = std::vector<std::jthread>( );
+			for( std::size_t n = 0; n < ranges.size( ); ++n ) {
+				threads.emplace_back( [&, n] {
+					auto range_r = daw::io::Reader( ranges[n] );
+					auto part_w = daw::io::Writer( parts[n] );
+					(void)daw::io::util::copy( part_w, range_r );
+				} );
+			}
+		}
+		auto joined = std::string( );
+		for( auto const &part : parts ) {
+			joined += part;
+		}
+		if( joined != expected or ranges[1].offset != layout[2].offset ) {
+			std::terminate( );
+		}
+		{
+			auto threads = std::vector<std::jthread>( );
+			for( std::size_t n = 0; n < ranges.size( ); ++n ) {
+				threads.emplace_back( [&, n] {
+					auto out = daw::io::fd_at_offset{ dst_fd, layout[n].offset,
+					                                  layout[n].end };
+					(void)daw::io::Writer( out ).write( parts[n] );
+				} );
+			}
+		}
+		auto mr = daw::io::mmap_reader( dst_name );
+		if( mr.view( ) != daw::string_view( expected ) or
+		    ::lseek( dst_fd, 0, SEEK_CUR ) != 0 ) {
+			std::terminate( );
+		}
+		auto bounded = daw::io::fd_at_offset{ dst_fd, 0, 4 };
+		auto const br = daw::io::Writer( bounded ).write( "123456" );
+		if( br.status != daw::io::IOOpStatus::Error or br.count != 4 or
+		    bounded.remaining( ) != 0 ) {
+			std::terminate( );
+		}
+		::close( src_fd );
+		::close( dst_fd );
+		::unlink( src_name );
+		::unlink( dst_name );
+	}
+	{
+		// fd to fd copies happen in the kernel, with the pipe input using splice
+		char src_name[] = "/tmp/daw_read_write_src_XXXXXX";
+		char dst_name[] = "/tmp/daw_read_write_dst_XXXXXX";
+		int const src_fd = ::mkstemp( src_name );
+		int const dst_fd = ::mkstemp( dst_name );
+		int fds[2];
+		if( src_fd < 0 or dst_fd < 0 or ::pipe( fds ) != 0 ) {
+			std::terminate( );
+		}
+		auto src = daw::io::fd_wrap_t( src_fd );
+		auto dst = daw::io::fd_wrap_t( dst_fd );
+		auto pipe_in = daw::io::fd_wrap_t( fds[0] );
+		auto pipe_out = daw::io::fd_wrap_t( fds[1] );
+		(void)daw::io::Writer( src ).write( "copied in the kernel" );
+		::lseek( src_fd, 0, SEEK_SET );
+		auto src_r = daw::io::Reader( src );
+		auto dst_w = daw::io::Writer( dst );
+		auto const cr = daw::io::util::copy_n( dst_w, src_r, 6 );
+		auto const cr2 = daw::io::util::copy( dst_w, src_r );
+		if( cr.read_result.count != 6 or cr.write_result.count != 6 or
+		    cr2.read_result.status != daw::io::IOOpStatus::Eof or
+		    cr2.write_result.count != 14 ) {
+			std::terminate( );
+		}
+		(void)daw::io::Writer( pipe_out ).write( " and spliced" );
+		::close( fds[1] );
+		auto pipe_r = daw::io::Reader( pipe_in );
+		auto const cr3 = daw::io::util::copy( dst_w, pipe_r );
+		::close( fds[0] );
+		if( cr3.read_result.status != daw::io::IOOpStatus::Eof or
+		    cr3.write_result.count != 12 ) {
+			std::terminate( );
+		}
+		auto mr = daw::io::mmap_reader( dst_name );
+		if( mr.view( ) != daw::string_view( "copied in the kernel and spliced" ) ) {
+			std::terminate( );
+		}
+		::close( src_fd );
+		::close( dst_fd );
+		::unlink( src_name );
+		::unlink( dst_name );
+		// Types without a KernelCopy use the buffered loop
+		auto copy_sv = daw::string_view( "buffered copy" );
+		auto copy_str = std::string( );
+		auto copy_svr = daw::io::Reader( copy_sv );
+		auto copy_strw = daw::io::Writer( copy_str );
+		auto const cr4 = daw::io::util::copy_n( copy_strw, copy_svr, 8 );
+		if( cr4.write_result.count != 8 or copy_str != "buffered" ) {
+			std::terminate( );
+		}
+		std::byte small_buff[3];
+		auto const cr5 =
+		  daw::io::util::copy_n( copy_strw, copy_svr, 3, std::span( small_buff ) );
+		if( cr5.write_result.count != 3 or copy_str != "buffered co" ) {
+			std::terminate( );
+		}
+		auto long_str = std::string( 10000, 'z' );
+		auto long_sv = daw::string_view( long_str );
+		auto long_svr = daw::io::Reader( long_sv );
+		auto const cr6 = daw::io::util::copy(
+		  copy_strw, long_svr, daw::io::util::adaptive_buffer{ 2, 512 } );
+		if( cr6.read_result.status != daw::io::IOOpStatus::Eof or
+		    cr6.write_result.count != 10000 or copy_str.size( ) != 10011 ) {
+			std::terminate( );
+		}
+	}
+	{
+		auto bfd = daw::io::BufferedWriter( fd );
+		auto bfdw = daw::io::WriteProxy( bfd );
+		(void)daw::io::type_writer::write_all( bfdw, "\nBuffered ", 1, ' ', 2U,
+		                                       '\n' );
+		if( bfd.flush( ).status != daw::io::IOOpStatus::Ok ) {
+			std::terminate( );
+		}
+	}
 #endif
 }